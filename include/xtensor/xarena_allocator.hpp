@@ -0,0 +1,682 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ARENA_ALLOCATOR_HPP
+#define XTENSOR_ARENA_ALLOCATOR_HPP
+
+// This header is included by xtensor_config.hpp when XTENSOR_USE_ARENA_ALLOCATOR
+// is defined, it must not include any other xtensor header.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Largest block, in bytes, served by the arena; larger blocks are allocated on the heap
+#ifndef XTENSOR_ARENA_MAX_BLOCK_SIZE
+#define XTENSOR_ARENA_MAX_BLOCK_SIZE (std::size_t(1) << 20)
+#endif
+
+// Size, in bytes, of the chunks the arena carves its blocks from, a power of two
+#ifndef XTENSOR_ARENA_CHUNK_SIZE
+#define XTENSOR_ARENA_CHUNK_SIZE (std::size_t(1) << 22)
+#endif
+
+namespace xt
+{
+    namespace detail
+    {
+        // Every block is aligned on 64 bytes, which is enough for any SIMD
+        // instruction set supported by xsimd.
+        constexpr std::size_t arena_alignment = 64;
+        constexpr std::size_t arena_min_block_size = 64;
+
+        constexpr std::size_t arena_class_count(std::size_t size)
+        {
+            return size <= arena_min_block_size ? 1 : 1 + arena_class_count(size / 2);
+        }
+
+        constexpr std::size_t arena_nb_classes = arena_class_count(XTENSOR_ARENA_MAX_BLOCK_SIZE);
+
+        static_assert((XTENSOR_ARENA_CHUNK_SIZE & (XTENSOR_ARENA_CHUNK_SIZE - 1)) == 0,
+                      "the size of the arena chunks must be a power of two");
+        static_assert(XTENSOR_ARENA_CHUNK_SIZE >= XTENSOR_ARENA_MAX_BLOCK_SIZE + arena_alignment,
+                      "the arena chunks must be able to hold the largest block");
+
+        inline void* arena_aligned_allocate(std::size_t size)
+        {
+            char* raw = static_cast<char*>(::operator new(size + arena_alignment));
+            std::size_t shift = arena_alignment - reinterpret_cast<std::uintptr_t>(raw) % arena_alignment;
+            char* res = raw + shift;
+            res[-1] = static_cast<char>(shift - 1);
+            return res;
+        }
+
+        inline void arena_aligned_deallocate(void* p) noexcept
+        {
+            char* res = static_cast<char*>(p);
+            std::size_t shift = static_cast<std::size_t>(static_cast<unsigned char>(res[-1])) + 1;
+            ::operator delete(res - shift);
+        }
+
+        class xarena;
+
+        // Header stored in the first bytes of each chunk. The chunks are
+        // aligned on their size, so the header of the chunk holding a block
+        // is found from the address of the block, without any lookup.
+        struct arena_chunk_header
+        {
+            void* m_raw;
+            xarena* m_owner;
+            // 0 for the chunks of the thread region, k for those
+            // of the k-th nested scope of the owner
+            std::size_t m_depth;
+        };
+
+        static_assert(sizeof(arena_chunk_header) <= arena_alignment,
+                      "the chunk header must fit before the first block");
+
+        inline arena_chunk_header* arena_header_of(const void* p) noexcept
+        {
+            std::uintptr_t chunk = reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t(XTENSOR_ARENA_CHUNK_SIZE) - 1);
+            return reinterpret_cast<arena_chunk_header*>(chunk);
+        }
+
+        /*****************
+         * xarena_chunks *
+         *****************/
+
+        // Process-wide owner of the chunks and of the arenas, which are only
+        // released at exit. The arena of a thread that exits is kept with
+        // its chunks and its free lists, and handed over to the next thread
+        // that needs one; blocks still referred to by other threads remain
+        // valid, and are given back to that arena when they are deallocated.
+        // Threads whose arena has been released allocate from a shared one.
+        class xarena_chunks
+        {
+        public:
+
+            static xarena_chunks& instance();
+            static char* allocate();
+
+            xarena* acquire_arena();
+            void release_arena(xarena* arena);
+            void* allocate_shared(std::size_t size);
+
+        private:
+
+            xarena_chunks() = default;
+            ~xarena_chunks();
+
+            xarena* new_arena();
+
+            std::mutex m_mutex;
+            std::vector<char*> m_chunks;
+            std::vector<xarena*> m_arenas;
+            std::vector<xarena*> m_orphans;
+            std::mutex m_shared_mutex;
+            xarena* p_shared = nullptr;
+        };
+
+        /**********
+         * xarena *
+         **********/
+
+        // Size-class pool used by a single thread at a time. Blocks are carved
+        // from chunks and recycled through one intrusive free list per size
+        // class. Each xarena_scope opens a region with its own chunks and free
+        // lists, whose chunks are recycled all at once when the scope ends.
+        // A block deallocated by another thread is pushed onto the remote free
+        // list of the arena owning its chunk, which the owner moves back to
+        // its free lists when they run out of blocks.
+        class xarena
+        {
+        public:
+
+            static xarena* instance();
+
+            static void* allocate_block(std::size_t size);
+            static void deallocate_block(void* p, std::size_t size) noexcept;
+
+            void* allocate(std::size_t size);
+
+            void push_scope();
+            bool pop_scope() noexcept;
+
+        private:
+
+            struct free_block
+            {
+                free_block* next;
+                std::size_t index;
+            };
+
+            struct region
+            {
+                region();
+
+                std::vector<char*> m_chunks;
+                char* m_cursor;
+                char* m_end;
+                std::array<free_block*, arena_nb_classes> m_free_lists;
+                std::size_t m_live_blocks;
+            };
+
+            // Hands the arena of the thread back to xarena_chunks on exit
+            struct thread_handle
+            {
+                thread_handle();
+                ~thread_handle();
+
+                xarena* p_arena;
+            };
+
+            xarena();
+
+            static bool& destroyed() noexcept;
+            static xarena*& local() noexcept;
+            static std::size_t class_index(std::size_t size) noexcept;
+
+            void deallocate(void* p, std::size_t index, const arena_chunk_header& header) noexcept;
+            void deallocate_remote(void* p, std::size_t index) noexcept;
+            void reclaim_remote_blocks() noexcept;
+
+            region& current_region() noexcept;
+            region& region_at(std::size_t depth) noexcept;
+            char* new_chunk();
+
+            region m_region;
+            std::vector<region> m_scopes;
+            std::vector<char*> m_spare_chunks;
+            std::atomic<free_block*> m_remote_blocks;
+
+            friend class xarena_chunks;
+        };
+    }
+
+    /****************
+     * xarena_scope *
+     ****************/
+
+    /**
+     * @class xarena_scope
+     * @brief Scope releasing in bulk the blocks allocated by xarena_allocator.
+     *
+     * While an xarena_scope is alive, the blocks allocated by xarena_allocator
+     * on the current thread come from a region owned by the scope; when the
+     * scope is destroyed, the whole region is recycled at once. Containers
+     * allocated within a scope should be destroyed before the end of the
+     * scope: otherwise, the region is merged into the enclosing one instead
+     * of being recycled, so that the blocks stay valid, and the scope is
+     * counted by outliving_scopes. Scopes can be nested; they have no effect
+     * once the arena of the thread has been destroyed.
+     */
+    class xarena_scope
+    {
+    public:
+
+        xarena_scope();
+        ~xarena_scope();
+
+        xarena_scope(const xarena_scope&) = delete;
+        xarena_scope& operator=(const xarena_scope&) = delete;
+
+        static std::size_t outliving_scopes() noexcept;
+
+    private:
+
+        static std::atomic<std::size_t>& outliving_counter() noexcept;
+
+        detail::xarena* p_arena;
+    };
+
+    /********************
+     * xarena_allocator *
+     ********************/
+
+    /**
+     * @class xarena_allocator
+     * @brief Thread-local pool allocator.
+     *
+     * Blocks up to XTENSOR_ARENA_MAX_BLOCK_SIZE bytes are served from
+     * thread-local free lists, one per power-of-two size class, so that the
+     * temporaries of expressions do not contend on the global heap; larger
+     * blocks are allocated on the heap. A block can be deallocated by any
+     * thread, it is then given back to the arena it was allocated from.
+     * All blocks are aligned on 64 bytes. Defining XTENSOR_USE_ARENA_ALLOCATOR
+     * makes it the default allocator.
+     *
+     * @tparam T the type of the allocated elements.
+     */
+    template <class T>
+    class xarena_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = xarena_allocator<U>;
+        };
+
+        xarena_allocator() noexcept = default;
+
+        template <class U>
+        xarena_allocator(const xarena_allocator<U>&) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+    };
+
+    template <class T, class U>
+    bool operator==(const xarena_allocator<T>&, const xarena_allocator<U>&) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const xarena_allocator<T>&, const xarena_allocator<U>&) noexcept;
+
+    /********************************
+     * xarena_chunks implementation *
+     ********************************/
+
+    namespace detail
+    {
+        // The chunk is aligned on its size within an allocation twice as
+        // large; the pages of the unused part are never touched.
+        inline char* xarena_chunks::allocate()
+        {
+            void* raw = ::operator new(2 * XTENSOR_ARENA_CHUNK_SIZE);
+            std::uintptr_t mask = std::uintptr_t(XTENSOR_ARENA_CHUNK_SIZE) - 1;
+            char* chunk = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(raw) + mask) & ~mask);
+            new (chunk) arena_chunk_header{raw, nullptr, 0};
+            xarena_chunks& chunks = instance();
+            std::lock_guard<std::mutex> lock(chunks.m_mutex);
+            chunks.m_chunks.push_back(chunk);
+            return chunk;
+        }
+
+        inline xarena* xarena_chunks::acquire_arena()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_orphans.empty())
+            {
+                xarena* arena = m_orphans.back();
+                m_orphans.pop_back();
+                return arena;
+            }
+            return new_arena();
+        }
+
+        inline void xarena_chunks::release_arena(xarena* arena)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_orphans.push_back(arena);
+        }
+
+        // The shared arena is only used under its own mutex; the blocks
+        // deallocated by any thread go through its remote free list.
+        inline void* xarena_chunks::allocate_shared(std::size_t size)
+        {
+            std::lock_guard<std::mutex> lock(m_shared_mutex);
+            if (p_shared == nullptr)
+            {
+                std::lock_guard<std::mutex> arenas_lock(m_mutex);
+                p_shared = new_arena();
+            }
+            return p_shared->allocate(size);
+        }
+
+        inline xarena* xarena_chunks::new_arena()
+        {
+            m_arenas.reserve(m_arenas.size() + 1);
+            m_arenas.push_back(new xarena());
+            return m_arenas.back();
+        }
+
+        inline xarena_chunks::~xarena_chunks()
+        {
+            for (xarena* arena : m_arenas)
+            {
+                delete arena;
+            }
+            for (char* chunk : m_chunks)
+            {
+                ::operator delete(reinterpret_cast<arena_chunk_header*>(chunk)->m_raw);
+            }
+        }
+
+        inline xarena_chunks& xarena_chunks::instance()
+        {
+            static xarena_chunks chunks;
+            return chunks;
+        }
+
+        /*************************
+         * xarena implementation *
+         *************************/
+
+        inline xarena::region::region()
+            : m_chunks(), m_cursor(nullptr), m_end(nullptr), m_free_lists(), m_live_blocks(0)
+        {
+            m_free_lists.fill(nullptr);
+        }
+
+        // The chunks must outlive the thread-local handles,
+        // so they are created first
+        inline xarena::thread_handle::thread_handle()
+            : p_arena(xarena_chunks::instance().acquire_arena())
+        {
+            local() = p_arena;
+        }
+
+        inline xarena::thread_handle::~thread_handle()
+        {
+            destroyed() = true;
+            local() = nullptr;
+            xarena_chunks::instance().release_arena(p_arena);
+        }
+
+        inline xarena::xarena()
+            : m_region(), m_scopes(), m_spare_chunks(), m_remote_blocks(nullptr)
+        {
+        }
+
+        // Returns nullptr once the arena of the thread has been released,
+        // which happens when containers with static storage duration are
+        // destroyed after the thread-local objects of the main thread.
+        inline xarena* xarena::instance()
+        {
+            if (destroyed())
+            {
+                return nullptr;
+            }
+            thread_local thread_handle handle;
+            return handle.p_arena;
+        }
+
+        inline void* xarena::allocate_block(std::size_t size)
+        {
+            xarena* arena = instance();
+            return arena != nullptr ? arena->allocate(size) : xarena_chunks::instance().allocate_shared(size);
+        }
+
+        // A small block goes back to the arena owning its chunk: directly if
+        // it is the arena of the current thread, through its remote free
+        // list otherwise, including when the current thread has none.
+        inline void xarena::deallocate_block(void* p, std::size_t size) noexcept
+        {
+            if (size > XTENSOR_ARENA_MAX_BLOCK_SIZE)
+            {
+                arena_aligned_deallocate(p);
+                return;
+            }
+            const arena_chunk_header& header = *arena_header_of(p);
+            std::size_t index = class_index(size);
+            if (local() == header.m_owner)
+            {
+                header.m_owner->deallocate(p, index, header);
+            }
+            else
+            {
+                header.m_owner->deallocate_remote(p, index);
+            }
+        }
+
+        inline void* xarena::allocate(std::size_t size)
+        {
+            if (size > XTENSOR_ARENA_MAX_BLOCK_SIZE)
+            {
+                return arena_aligned_allocate(size);
+            }
+            std::size_t index = class_index(size);
+            region& r = current_region();
+            if (r.m_free_lists[index] == nullptr && m_remote_blocks.load(std::memory_order_relaxed) != nullptr)
+            {
+                reclaim_remote_blocks();
+            }
+            free_block* block = r.m_free_lists[index];
+            if (block != nullptr)
+            {
+                r.m_free_lists[index] = block->next;
+                ++r.m_live_blocks;
+                return block;
+            }
+            std::size_t block_size = arena_min_block_size << index;
+            if (r.m_cursor == nullptr || static_cast<std::size_t>(r.m_end - r.m_cursor) < block_size)
+            {
+                r.m_chunks.push_back(new_chunk());
+                arena_chunk_header* header = reinterpret_cast<arena_chunk_header*>(r.m_chunks.back());
+                header->m_depth = m_scopes.size();
+                r.m_cursor = r.m_chunks.back() + arena_alignment;
+                r.m_end = r.m_chunks.back() + XTENSOR_ARENA_CHUNK_SIZE;
+            }
+            char* res = r.m_cursor;
+            r.m_cursor += block_size;
+            ++r.m_live_blocks;
+            return res;
+        }
+
+        inline void xarena::push_scope()
+        {
+            m_scopes.emplace_back();
+        }
+
+        // Returns false if a block allocated within the scope has not been
+        // deallocated; the region of the scope is then merged into the
+        // enclosing one instead of being recycled, so that the block stays
+        // valid.
+        inline bool xarena::pop_scope() noexcept
+        {
+            reclaim_remote_blocks();
+            region& r = m_scopes.back();
+            bool released = r.m_live_blocks == 0;
+            if (released)
+            {
+                m_spare_chunks.insert(m_spare_chunks.end(), r.m_chunks.begin(), r.m_chunks.end());
+            }
+            else
+            {
+                std::size_t depth = m_scopes.size() - 1;
+                region& parent = region_at(depth);
+                for (char* chunk : r.m_chunks)
+                {
+                    reinterpret_cast<arena_chunk_header*>(chunk)->m_depth = depth;
+                }
+                parent.m_chunks.insert(parent.m_chunks.end(), r.m_chunks.begin(), r.m_chunks.end());
+                parent.m_live_blocks += r.m_live_blocks;
+                for (std::size_t index = 0; index < arena_nb_classes; ++index)
+                {
+                    while (r.m_free_lists[index] != nullptr)
+                    {
+                        free_block* block = r.m_free_lists[index];
+                        r.m_free_lists[index] = block->next;
+                        block->next = parent.m_free_lists[index];
+                        parent.m_free_lists[index] = block;
+                    }
+                }
+            }
+            m_scopes.pop_back();
+            return released;
+        }
+
+        inline bool& xarena::destroyed() noexcept
+        {
+            thread_local bool flag = false;
+            return flag;
+        }
+
+        // Arena of the current thread, nullptr if it has not
+        // been created yet or if it has been released
+        inline xarena*& xarena::local() noexcept
+        {
+            thread_local xarena* arena = nullptr;
+            return arena;
+        }
+
+        inline std::size_t xarena::class_index(std::size_t size) noexcept
+        {
+            std::size_t index = 0;
+            while ((arena_min_block_size << index) < size)
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        // Blocks allocated within a scope go back to the free lists of that
+        // scope, any other block goes back to the free lists of the thread.
+        inline void xarena::deallocate(void* p, std::size_t index, const arena_chunk_header& header) noexcept
+        {
+            region& r = region_at(header.m_depth);
+            free_block* block = static_cast<free_block*>(p);
+            block->next = r.m_free_lists[index];
+            r.m_free_lists[index] = block;
+            --r.m_live_blocks;
+        }
+
+        // Lock-free push; the owner takes the whole list at once, so
+        // that a block cannot be popped while it is being pushed.
+        inline void xarena::deallocate_remote(void* p, std::size_t index) noexcept
+        {
+            free_block* block = static_cast<free_block*>(p);
+            block->index = index;
+            free_block* head = m_remote_blocks.load(std::memory_order_relaxed);
+            do
+            {
+                block->next = head;
+            } while (!m_remote_blocks.compare_exchange_weak(head, block,
+                                                            std::memory_order_release,
+                                                            std::memory_order_relaxed));
+        }
+
+        inline void xarena::reclaim_remote_blocks() noexcept
+        {
+            free_block* block = m_remote_blocks.exchange(nullptr, std::memory_order_acquire);
+            while (block != nullptr)
+            {
+                free_block* next = block->next;
+                deallocate(block, block->index, *arena_header_of(block));
+                block = next;
+            }
+        }
+
+        inline auto xarena::current_region() noexcept -> region&
+        {
+            return region_at(m_scopes.size());
+        }
+
+        inline auto xarena::region_at(std::size_t depth) noexcept -> region&
+        {
+            return depth == 0 ? m_region : m_scopes[depth - 1];
+        }
+
+        inline char* xarena::new_chunk()
+        {
+            char* chunk = nullptr;
+            if (!m_spare_chunks.empty())
+            {
+                chunk = m_spare_chunks.back();
+                m_spare_chunks.pop_back();
+            }
+            else
+            {
+                chunk = xarena_chunks::allocate();
+            }
+            reinterpret_cast<arena_chunk_header*>(chunk)->m_owner = this;
+            return chunk;
+        }
+    }
+
+    /*******************************
+     * xarena_scope implementation *
+     *******************************/
+
+    inline xarena_scope::xarena_scope()
+        : p_arena(detail::xarena::instance())
+    {
+        if (p_arena != nullptr)
+        {
+            p_arena->push_scope();
+        }
+    }
+
+    inline xarena_scope::~xarena_scope()
+    {
+        if (p_arena != nullptr && !p_arena->pop_scope())
+        {
+            outliving_counter().fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Returns the number of scopes, on all the threads, that ended while a
+     * block allocated within them was still in use.
+     */
+    inline std::size_t xarena_scope::outliving_scopes() noexcept
+    {
+        return outliving_counter().load(std::memory_order_relaxed);
+    }
+
+    inline std::atomic<std::size_t>& xarena_scope::outliving_counter() noexcept
+    {
+        static std::atomic<std::size_t> counter(0);
+        return counter;
+    }
+
+    /***********************************
+     * xarena_allocator implementation *
+     ***********************************/
+
+    template <class T>
+    template <class U>
+    inline xarena_allocator<T>::xarena_allocator(const xarena_allocator<U>&) noexcept
+    {
+    }
+
+    template <class T>
+    inline T* xarena_allocator<T>::allocate(std::size_t n)
+    {
+        return static_cast<T*>(detail::xarena::allocate_block(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void xarena_allocator<T>::deallocate(T* p, std::size_t n) noexcept
+    {
+        if (p != nullptr)
+        {
+            detail::xarena::deallocate_block(p, n * sizeof(T));
+        }
+    }
+
+    template <class T, class U>
+    inline bool operator==(const xarena_allocator<T>&, const xarena_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const xarena_allocator<T>&, const xarena_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
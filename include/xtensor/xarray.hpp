@@ -142,6 +142,12 @@ namespace xt
         template <class E>
         xarray_container& operator=(const xexpression<E>& e);
 
+        template <class F, class... CT>
+        xarray_container(xfunction<F, CT...>&& e);
+
+        template <class F, class... CT>
+        xarray_container& operator=(xfunction<F, CT...>&& e);
+
     private:
 
         storage_type m_storage;
@@ -491,6 +497,43 @@ namespace xt
     {
         return semantic_base::operator=(e);
     }
+
+    /**
+     * The extended move constructor. If an operand of \c e is a temporary
+     * container of the same type as this one and has the shape of \c e, the
+     * expression is evaluated in the buffer of this operand, which is then
+     * moved into the constructed container.
+     */
+    template <class EC, layout_type L, class SC, class Tag>
+    template <class F, class... CT>
+    inline xarray_container<EC, L, SC, Tag>::xarray_container(xfunction<F, CT...>&& e)
+        : base_type()
+    {
+        if (!detail::reuse_operand_buffer(*this, e))
+        {
+            if (e.dimension() == 0)
+            {
+                detail::resize_data_container(m_storage, std::size_t(1));
+            }
+            semantic_base::assign(e);
+        }
+    }
+
+    /**
+     * The extended move assignment operator. Reuses the buffer of a
+     * temporary operand of \c e when possible, see the extended move
+     * constructor.
+     */
+    template <class EC, layout_type L, class SC, class Tag>
+    template <class F, class... CT>
+    inline auto xarray_container<EC, L, SC, Tag>::operator=(xfunction<F, CT...>&& e) -> self_type&
+    {
+        if (detail::reuse_operand_buffer(*this, e))
+        {
+            return *this;
+        }
+        return semantic_base::operator=(e);
+    }
     //@}
 
     template <class EC, layout_type L, class SC, class Tag>
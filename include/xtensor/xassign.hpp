@@ -242,11 +242,39 @@ namespace xt
                                   select_layout<E2::static_layout, typename E2::shape_type>::value) != layout_type::dynamic;
         }
 
+        template <class E>
+        struct is_padded_container : std::false_type
+        {
+        };
+
+        template <class EC, std::size_t N, class Tag>
+        struct is_padded_container<xtensor_padded_container<EC, N, Tag>> : std::true_type
+        {
+        };
+
+        template <class E>
+        inline bool has_padded_rows(const E& e, std::true_type) noexcept
+        {
+            return e.padding() != 0;
+        }
+
+        template <class E>
+        inline bool has_padded_rows(const E&, std::false_type) noexcept
+        {
+            return false;
+        }
+
+        template <class E>
+        inline bool has_padded_rows(const E& e) noexcept
+        {
+            return has_padded_rows(e, is_padded_container<E>());
+        }
+
         template <class E1, class E2>
         inline auto is_linear_assign(const E1& e1, const E2& e2) -> std::enable_if_t<has_strides<E1>::value, bool>
         {
             return (E1::contiguous_layout && E2::contiguous_layout && linear_static_layout<E1, E2>()) ||
-                   (e1.layout() != layout_type::dynamic && e2.has_linear_assign(e1.strides()));
+                   (e1.layout() != layout_type::dynamic && !has_padded_rows(e1) && e2.has_linear_assign(e1.strides()));
         }
 
         template <class E1, class E2>
@@ -785,8 +813,8 @@ namespace xt
         {
             using strides_type = S;
 
-            check_strides_functor(const S& strides)
-                : m_cut(L == layout_type::row_major ? 0 : strides.size()),
+            check_strides_functor(const S& strides, std::size_t cut)
+                : m_cut(cut),
                   m_strides(strides)
             {
             }
@@ -834,20 +862,59 @@ namespace xt
             const strides_type& m_strides;
         };
 
+        // Returns the index of the first dimension (row_major) or the number
+        // of dimensions (column_major) of the innermost contiguous block of e
+        template <class E>
+        std::size_t contiguous_cut(const E& e, bool is_row_major)
+        {
+            using strides_value_type = typename std::decay_t<decltype(e.strides())>::value_type;
+            const auto& shape = e.shape();
+            const auto& strides = e.strides();
+            std::size_t dim = e.dimension();
+            strides_value_type expected = 1;
+            if (is_row_major)
+            {
+                std::size_t cut = dim;
+                for (; cut != 0; --cut)
+                {
+                    if (shape[cut - 1] != 1 && strides[cut - 1] != expected)
+                    {
+                        break;
+                    }
+                    expected *= static_cast<strides_value_type>(shape[cut - 1]);
+                }
+                return cut;
+            }
+            else
+            {
+                std::size_t cut = 0;
+                for (; cut != dim; ++cut)
+                {
+                    if (shape[cut] != 1 && strides[cut] != expected)
+                    {
+                        break;
+                    }
+                    expected *= static_cast<strides_value_type>(shape[cut]);
+                }
+                return cut;
+            }
+        }
+
         template <class E1, class E2>
         auto get_loop_sizes(const E1& e1, const E2& e2, bool is_row_major)
         {
             std::size_t cut = 0;
 
-            // TODO! if E1 is !contiguous --> initialize cut to sensible value!
+            // The inner loop cannot span more than the contiguous block of e1
+            // (for instance, rows of a view or padded rows)
             if (E1::static_layout == layout_type::row_major || is_row_major)
             {
-                auto csf = check_strides_functor<layout_type::row_major, decltype(e1.strides())>(e1.strides());
+                auto csf = check_strides_functor<layout_type::row_major, decltype(e1.strides())>(e1.strides(), contiguous_cut(e1, true));
                 cut = csf(e2);
             }
             else if (E1::static_layout == layout_type::column_major || !is_row_major)
             {
-                auto csf = check_strides_functor<layout_type::column_major, decltype(e1.strides())>(e1.strides());
+                auto csf = check_strides_functor<layout_type::column_major, decltype(e1.strides())>(e1.strides(), contiguous_cut(e1, false));
                 cut = csf(e2);
             } // can't reach here because this would have already triggered the fallback
 
@@ -866,6 +933,68 @@ namespace xt
 
             return std::make_tuple(inner_loop_size, outer_loop_size, cut);
         }
+
+        template <class E>
+        struct padded_operand : detail::is_padded_container<E>
+        {
+        };
+
+        template <class T>
+        struct padded_operand<xscalar<T>> : std::true_type
+        {
+        };
+
+        template <class F, class... CT>
+        struct padded_operand<xfunction<F, CT...>>
+            : xtl::conjunction<padded_operand<std::decay_t<CT>>...>
+        {
+        };
+
+        template <class E1, class T>
+        inline bool same_padded_rows(const E1&, const xscalar<T>&) noexcept
+        {
+            return true;
+        }
+
+        template <class E1, class EC, std::size_t N, class Tag>
+        inline bool same_padded_rows(const E1& e1, const xtensor_padded_container<EC, N, Tag>& e) noexcept
+        {
+            return e1.dimension() == e.dimension() &&
+                   std::equal(e1.shape().cbegin(), e1.shape().cend(), e.shape().cbegin()) &&
+                   std::equal(e1.strides().cbegin(), e1.strides().cend(), e.strides().cbegin());
+        }
+
+        template <class E1, class F, class... CT>
+        inline bool same_padded_rows(const E1& e1, const xfunction<F, CT...>& e) noexcept
+        {
+            auto func = [&e1](bool res, const auto& arg) noexcept { return res && same_padded_rows(e1, arg); };
+            return accumulate(func, true, e.arguments());
+        }
+
+        template <class E1, class E2>
+        inline bool has_padded_tail(const E1&, const E2&, std::size_t, std::size_t, std::false_type) noexcept
+        {
+            return false;
+        }
+
+        template <class E1, class E2>
+        inline bool has_padded_tail(const E1& e1, const E2& e2, std::size_t inner_loop_size,
+                                    std::size_t batch_size, std::true_type) noexcept
+        {
+            std::size_t batch_end = (inner_loop_size + batch_size - 1) / batch_size * batch_size;
+            return e1.dimension() != 0 && inner_loop_size == e1.shape().back() &&
+                   batch_end <= e1.pitch() && same_padded_rows(e1, e2);
+        }
+
+        // Returns true if the last batch of each row can be computed with
+        // full SIMD batches, i.e. if all the operands have the same padded
+        // rows as e1 and the padding holds the end of the last batch.
+        template <class E1, class E2>
+        inline bool has_padded_tail(const E1& e1, const E2& e2, std::size_t inner_loop_size, std::size_t batch_size) noexcept
+        {
+            using is_padded = xtl::conjunction<detail::is_padded_container<E1>, padded_operand<E2>>;
+            return has_padded_tail(e1, e2, inner_loop_size, batch_size, is_padded());
+        }
     }
 
     template <bool simd>
@@ -937,6 +1066,11 @@ namespace xt
 
         std::size_t simd_size = inner_loop_size / simd_type::size;
         std::size_t simd_rest = inner_loop_size % simd_type::size;
+        if (is_row_major && strided_assign_detail::has_padded_tail(e1, e2, inner_loop_size, simd_type::size))
+        {
+            simd_size = (inner_loop_size + simd_type::size - 1) / simd_type::size;
+            simd_rest = 0;
+        }
 
         auto fct_stepper = e2.stepper_begin(e1.shape());
         auto res_stepper = e1.stepper_begin(e1.shape());
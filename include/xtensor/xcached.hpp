@@ -0,0 +1,455 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CACHED_HPP
+#define XTENSOR_CACHED_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "xaccessible.hpp"
+#include "xarray.hpp"
+#include "xexpression.hpp"
+#include "xexpression_traits.hpp"
+#include "xiterable.hpp"
+#include "xtensor.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /**********
+     * cached *
+     **********/
+
+    template <class E>
+    auto cached(E&& e);
+
+    /***********
+     * xcached *
+     ***********/
+
+    template <class CT>
+    class xcached;
+
+    namespace detail
+    {
+        template <class CT>
+        struct xcached_state
+        {
+            using xexpression_type = std::decay_t<CT>;
+            using cache_type = temporary_type_t<typename xexpression_type::value_type,
+                                                typename xexpression_type::shape_type,
+                                                XTENSOR_DEFAULT_LAYOUT>;
+
+            template <class CTA>
+            explicit xcached_state(CTA&& e);
+
+            const cache_type& value();
+
+            CT m_e;
+            std::once_flag m_flag;
+            cache_type m_cache;
+        };
+    }
+
+    template <class CT>
+    struct xiterable_inner_types<xcached<CT>>
+    {
+        using cache_type = typename detail::xcached_state<CT>::cache_type;
+        using inner_shape_type = typename cache_type::inner_shape_type;
+        using const_stepper = typename cache_type::const_stepper;
+        using stepper = const_stepper;
+    };
+
+    template <class CT>
+    struct xcontainer_inner_types<xcached<CT>>
+    {
+        using cache_type = typename detail::xcached_state<CT>::cache_type;
+        using reference = typename cache_type::const_reference;
+        using const_reference = typename cache_type::const_reference;
+        using size_type = typename cache_type::size_type;
+    };
+
+    /**
+     * @class xcached
+     * @brief Expression evaluated once, on first access.
+     *
+     * The xcached class wraps an expression that is expensive to compute
+     * and used several times in a larger expression. The first access to
+     * the xcached evaluates the whole expression into a temporary container,
+     * all the subsequent accesses read this container. Copies of an xcached
+     * share the same container, so the expression is evaluated once however
+     * many times the xcached appears in other expressions.
+     *
+     * The evaluation is thread safe, and happens when the enclosing
+     * expression is assigned (it computes the shape of the operands before
+     * anything else). Modifying the operands of the wrapped expression
+     * after that is not reflected by the xcached.
+     *
+     * xcached is not meant to be used directly, but only with the \ref cached
+     * helper function.
+     *
+     * @tparam CT the closure type of the \ref xexpression to cache
+     *
+     * @sa cached
+     */
+    template <class CT>
+    class xcached : public xsharable_expression<xcached<CT>>,
+                    public xconst_iterable<xcached<CT>>,
+                    public xconst_accessible<xcached<CT>>
+    {
+    public:
+
+        using self_type = xcached<CT>;
+        using xexpression_type = std::decay_t<CT>;
+        using accessible_base = xconst_accessible<self_type>;
+        using cache_type = typename detail::xcached_state<CT>::cache_type;
+
+        using inner_types = xcontainer_inner_types<self_type>;
+        using value_type = typename cache_type::value_type;
+        using reference = typename inner_types::reference;
+        using const_reference = typename inner_types::const_reference;
+        using pointer = typename cache_type::const_pointer;
+        using const_pointer = typename cache_type::const_pointer;
+        using size_type = typename inner_types::size_type;
+        using difference_type = typename cache_type::difference_type;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+        using strides_type = typename cache_type::strides_type;
+        using backstrides_type = typename cache_type::backstrides_type;
+        using inner_strides_type = typename cache_type::inner_strides_type;
+        using inner_backstrides_type = typename cache_type::inner_backstrides_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using bool_load_type = typename cache_type::bool_load_type;
+
+        static constexpr layout_type static_layout = cache_type::static_layout;
+        static constexpr bool contiguous_layout = cache_type::contiguous_layout;
+
+        template <class CTA>
+        explicit xcached(CTA&& e);
+
+        using accessible_base::size;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const;
+        layout_type layout() const;
+        bool is_contiguous() const;
+        using accessible_base::shape;
+
+        const inner_strides_type& strides() const;
+        const inner_backstrides_type& backstrides() const;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        const_reference data_element(size_type i) const;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xt_simd::simd_traits<requested_type>::size>
+        container_simd_return_type_t<typename cache_type::storage_type, value_type, requested_type>
+        load_simd(size_type i) const;
+
+        const xexpression_type& expression() const noexcept;
+        const cache_type& value() const;
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
+        template <class S>
+        bool has_linear_assign(const S& strides) const;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape, layout_type l) const;
+
+    private:
+
+        std::shared_ptr<detail::xcached_state<CT>> m_state;
+    };
+
+    /*******************
+     * xcached closure *
+     *******************/
+
+    template <class CT>
+    struct xclosure<xcached<CT>, std::enable_if_t<true>>
+    {
+        using type = xcached<CT>; // force copy
+    };
+
+    template <class CT>
+    struct const_xclosure<xcached<CT>&, std::enable_if_t<true>>
+    {
+        using type = xcached<CT>; // force copy
+    };
+
+    /*************************
+     * cached implementation *
+     *************************/
+
+    /**
+     * @brief Returns an \ref xexpression evaluated only once.
+     *
+     * Wraps \p e in an \ref xcached expression, that evaluates \p e into a
+     * temporary container on first access and reads this container for all the
+     * subsequent accesses. This avoids computing an expensive subexpression
+     * at each of its uses:
+     *
+     * \code{.cpp}
+     * // exp and log are computed once per element, instead of three times
+     * auto l = xt::cached(xt::log(xt::exp(a) + 1.));
+     * xt::xarray<double> res = l * b + l * c + l;
+     * \endcode
+     *
+     * Like \ref make_xshared, the returned expression can be used several times
+     * in an expression returned by a function: its copies share the cached
+     * values.
+     *
+     * @param e the \ref xexpression to cache
+     * @return an \ref xcached expression. It holds a const reference to \p e
+     * or a copy depending on whether \p e is an lvalue or an rvalue.
+     */
+    template <class E>
+    inline auto cached(E&& e)
+    {
+        static_assert(is_xexpression<E>::value, "cached requires an xexpression");
+        return xcached<const_xclosure_t<E>>(std::forward<E>(e));
+    }
+
+    /**************************
+     * xcached implementation *
+     **************************/
+
+    namespace detail
+    {
+        template <class CT>
+        template <class CTA>
+        inline xcached_state<CT>::xcached_state(CTA&& e)
+            : m_e(std::forward<CTA>(e))
+        {
+        }
+
+        template <class CT>
+        inline auto xcached_state<CT>::value() -> const cache_type&
+        {
+            std::call_once(m_flag, [this]() { m_cache = m_e; });
+            return m_cache;
+        }
+    }
+
+    /**
+     * Constructs an xcached expression wrapping the specified \ref xexpression.
+     *
+     * @param e the expression to cache
+     */
+    template <class CT>
+    template <class CTA>
+    inline xcached<CT>::xcached(CTA&& e)
+        : m_state(std::make_shared<detail::xcached_state<CT>>(std::forward<CTA>(e)))
+    {
+    }
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of dimensions of the expression. Does not
+     * evaluate the expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::dimension() const noexcept -> size_type
+    {
+        return expression().dimension();
+    }
+
+    /**
+     * Returns the shape of the expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::shape() const -> const inner_shape_type&
+    {
+        return value().shape();
+    }
+
+    /**
+     * Returns the layout of the cached values.
+     */
+    template <class CT>
+    inline layout_type xcached<CT>::layout() const
+    {
+        return value().layout();
+    }
+
+    template <class CT>
+    inline bool xcached<CT>::is_contiguous() const
+    {
+        return value().is_contiguous();
+    }
+
+    /**
+     * Returns the strides of the cached values.
+     */
+    template <class CT>
+    inline auto xcached<CT>::strides() const -> const inner_strides_type&
+    {
+        return value().strides();
+    }
+
+    /**
+     * Returns the backstrides of the cached values.
+     */
+    template <class CT>
+    inline auto xcached<CT>::backstrides() const -> const inner_backstrides_type&
+    {
+        return value().backstrides();
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a constant reference to the element at the specified position in the expression.
+     * @param args a list of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the expression.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xcached<CT>::operator()(Args... args) const -> const_reference
+    {
+        return value()(args...);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression,
+     * without broadcasting the indices.
+     * @param args a list of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices must be equal to the number of
+     * dimensions of the expression, else the behavior is undefined.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xcached<CT>::unchecked(Args... args) const -> const_reference
+    {
+        return value().unchecked(args...);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the expression.
+     */
+    template <class CT>
+    template <class It>
+    inline auto xcached<CT>::element(It first, It last) const -> const_reference
+    {
+        return value().element(first, last);
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::data_element(size_type i) const -> const_reference
+    {
+        return value().data_element(i);
+    }
+
+    template <class CT>
+    template <class align, class requested_type, std::size_t N>
+    inline auto xcached<CT>::load_simd(size_type i) const
+        -> container_simd_return_type_t<typename cache_type::storage_type, value_type, requested_type>
+    {
+        return value().template load_simd<align, requested_type, N>(i);
+    }
+
+    /**
+     * Returns a constant reference to the underlying expression of the xcached.
+     */
+    template <class CT>
+    inline auto xcached<CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_state->m_e;
+    }
+
+    /**
+     * Returns a constant reference to the container holding the cached
+     * values. The expression is evaluated if it has not been yet.
+     */
+    template <class CT>
+    inline auto xcached<CT>::value() const -> const cache_type&
+    {
+        return m_state->value();
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the expression to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CT>
+    template <class S>
+    inline bool xcached<CT>::broadcast_shape(S& shape, bool reuse_cache) const
+    {
+        return value().broadcast_shape(shape, reuse_cache);
+    }
+
+    /**
+     * Checks whether the xcached can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class CT>
+    template <class S>
+    inline bool xcached<CT>::has_linear_assign(const S& strides) const
+    {
+        return value().has_linear_assign(strides);
+    }
+    //@}
+
+    template <class CT>
+    template <class S>
+    inline auto xcached<CT>::stepper_begin(const S& shape) const -> const_stepper
+    {
+        return value().stepper_begin(shape);
+    }
+
+    template <class CT>
+    template <class S>
+    inline auto xcached<CT>::stepper_end(const S& shape, layout_type l) const -> const_stepper
+    {
+        return value().stepper_end(shape, l);
+    }
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include <functional>
 #include <numeric>
 #include <stdexcept>
+#include <vector>
 
 #include <xtl/xmeta_utils.hpp>
 #include <xtl/xsequence.hpp>
@@ -284,6 +285,11 @@ namespace xt
         template <class T>
         auto& reshape(std::initializer_list<T> shape, layout_type layout = base_type::static_layout) &;
 
+        void push_back(const value_type& value);
+
+        template <class E>
+        void append(const xexpression<E>& e);
+
         layout_type layout() const noexcept;
         bool is_contiguous() const noexcept;
 
@@ -319,6 +325,9 @@ namespace xt
 
     private:
 
+        void grow_rows(size_type nb_rows, size_type new_size);
+        void add_rows(size_type nb_rows);
+
         inner_shape_type m_shape;
         inner_strides_type m_strides;
         inner_backstrides_type m_backstrides;
@@ -861,6 +870,89 @@ namespace xt
         return m_backstrides;
     }
 
+    /**
+     * Appends an element to a one-dimensional container, preserving
+     * its elements. The capacity of the underlying storage grows
+     * geometrically, so that a sequence of push_back has an amortized
+     * constant cost.
+     * @param value the element to append
+     */
+    template <class D>
+    inline void xstrided_container<D>::push_back(const value_type& value)
+    {
+        if (m_shape.size() != 1)
+        {
+            XTENSOR_THROW(std::runtime_error, "push_back is only available for one-dimensional containers.");
+        }
+        // value may refer to an element of the container
+        value_type tmp = value;
+        size_type old_size = this->storage().size();
+        grow_rows(1, old_size + 1);
+        this->storage()[old_size] = std::move(tmp);
+    }
+
+    /**
+     * Appends the elements of an expression along the first axis of the
+     * container, preserving its elements. The expression has either the
+     * dimension of the container, in which case all its rows are appended,
+     * or one dimension less, in which case it is appended as a single row.
+     * The other dimensions of the expression must match the ones of the
+     * container. The capacity of the underlying storage grows geometrically,
+     * so that a sequence of append has an amortized linear cost.
+     * \code{.cpp}
+     * xt::xtensor<double, 2> a = xt::zeros<double>({0, 3});
+     * a.append(xt::xtensor<double, 1>{1., 2., 3.});
+     * a.append(xt::ones<double>({2, 3}));
+     * // a.shape() == {3, 3}
+     * \endcode
+     * @warning Containers of dimension greater than one must have
+     * a row_major layout.
+     * @param e the expression to append
+     */
+    template <class D>
+    template <class E>
+    inline void xstrided_container<D>::append(const xexpression<E>& e)
+    {
+        const E& de = e.derived_cast();
+        size_type dim = m_shape.size();
+        size_type e_dim = de.dimension();
+        if (dim == 0 || (e_dim != dim && e_dim + 1 != dim))
+        {
+            XTENSOR_THROW(std::runtime_error, "append: the expression must have the dimension of the container, or one less.");
+        }
+        if (dim > 1 && m_layout != layout_type::row_major)
+        {
+            XTENSOR_THROW(std::runtime_error, "append: only row_major containers can grow along their first axis.");
+        }
+        size_type offset = dim - e_dim;
+        if (!std::equal(m_shape.cbegin() + 1, m_shape.cend(), de.shape().cbegin() + (1 - offset)))
+        {
+            XTENSOR_THROW(std::runtime_error, "append: the shape of the expression does not match the shape of the container.");
+        }
+        size_type nb_rows = offset == 0 ? static_cast<size_type>(de.shape()[0]) : size_type(1);
+        size_type old_size = this->storage().size();
+        size_type new_size = old_size + static_cast<size_type>(compute_size(de.shape()));
+        if (new_size > this->storage().capacity())
+        {
+            // The expression may refer to the storage, which is about to be reallocated
+            std::vector<value_type> tmp(de.template cbegin<layout_type::row_major>(),
+                                        de.template cend<layout_type::row_major>());
+            grow_rows(nb_rows, new_size);
+            std::copy(tmp.cbegin(), tmp.cend(), this->storage().begin() + old_size);
+        }
+        else
+        {
+            // The expression may refer to the container: the storage is not
+            // reallocated, and the shape is only updated once the expression
+            // has been copied into its tail, so that the expression reads the
+            // elements of the container before the append only.
+            detail::grow_data_container(this->storage(), new_size);
+            std::copy(de.template cbegin<layout_type::row_major>(), de.template cend<layout_type::row_major>(),
+                      this->storage().begin() + old_size);
+            add_rows(nb_rows);
+        }
+    }
+
     /**
      * Return the layout_type of the container
      * @return layout_type of the container
@@ -895,6 +987,17 @@ namespace xt
             (void) size;
             XTENSOR_ASSERT_MSG(c.size() == size, "Trying to resize const data container with wrong size.");
         }
+
+        template <class C>
+        inline void grow_data_container(C& c, typename C::size_type size)
+        {
+            // Geometric growth makes a sequence of appends amortized linear
+            if (c.capacity() < size)
+            {
+                c.reserve(std::max(size, 2 * c.capacity()));
+            }
+            c.resize(size);
+        }
     }
 
     /**
@@ -1060,6 +1163,22 @@ namespace xt
         compute_strides<D::static_layout>(m_shape, m_layout, m_strides, m_backstrides);
     }
     
+    template <class D>
+    inline void xstrided_container<D>::grow_rows(size_type nb_rows, size_type new_size)
+    {
+        detail::grow_data_container(this->storage(), new_size);
+        add_rows(nb_rows);
+    }
+
+    template <class D>
+    inline void xstrided_container<D>::add_rows(size_type nb_rows)
+    {
+        inner_shape_type shape = m_shape;
+        shape[0] += nb_rows;
+        // The storage already has the new size, resize only updates the strides
+        resize(std::move(shape));
+    }
+
     template <class D>
     inline auto xstrided_container<D>::mutable_layout() noexcept -> layout_type&
     {
@@ -17,6 +17,7 @@
 #include <string>
 #include <utility>
 
+#include "xformat.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
 
@@ -36,6 +37,75 @@ namespace xt
     template <class E>
     void dump_csv(std::ostream& stream, const xexpression<E>& e);
 
+    struct xcsv_config
+    {
+        char delimiter;
+        std::size_t skip_rows;
+        std::ptrdiff_t max_rows;
+        std::string comments;
+
+        xcsv_config()
+            : delimiter(',')
+            , skip_rows(0)
+            , max_rows(-1)
+            , comments("#")
+        {
+        }
+    };
+
+    /*********************************
+     * xcsv_block_reader declaration *
+     *********************************/
+
+    /**
+     * @class xcsv_block_reader
+     * @brief Block-wise CSV reader.
+     *
+     * The xcsv_block_reader class parses a CSV stream by blocks of a fixed
+     * number of rows. Each block is written into the same 2-D tensor, whose
+     * buffer is reused from one block to the next, so that the memory footprint
+     * stays bounded by the block size whatever the size of the stream.
+     * The skip_rows, max_rows and comments options of the xcsv_config apply
+     * to the stream as a whole.
+     *
+     * @tparam T the value type of the blocks.
+     * @tparam A the allocator of the underlying buffer.
+     */
+    template <class T, class A = std::allocator<T>>
+    class xcsv_block_reader
+    {
+    public:
+
+        using block_type = xcsv_tensor<T, A>;
+        using size_type = typename block_type::size_type;
+
+        xcsv_block_reader(std::istream& stream, size_type block_rows, const xcsv_config& config = xcsv_config());
+
+        bool next();
+
+        const block_type& block() const noexcept;
+        size_type rows_read() const noexcept;
+
+    private:
+
+        using storage_type = typename block_type::storage_type;
+        using inner_shape_type = typename block_type::inner_shape_type;
+        using output_iterator = std::back_insert_iterator<storage_type>;
+
+        std::istream& m_stream;
+        size_type m_block_rows;
+        xcsv_config m_config;
+        block_type m_block;
+        size_type m_nbcol;
+        size_type m_nhead;
+        size_type m_nbrow;
+        std::string m_row;
+        std::string m_cell;
+    };
+
+    template <class T, class A = std::allocator<T>, class F>
+    std::size_t load_csv_blocks(std::istream& stream, std::size_t block_rows, F&& f, const xcsv_config& config = xcsv_config());
+
     /*****************************************
      * load_csv and dump_csv implementations *
      *****************************************/
@@ -164,7 +234,9 @@ namespace xt
 
     /**
      * @brief Dump tensor to CSV.
-     * 
+     *
+     * Integral and floating point values are written with their shortest
+     * decimal representation that parses back to the same value.
      * @param stream the output stream to write the CSV encoded values
      * @param e the tensor expression to serialize
      */
@@ -179,41 +251,153 @@ namespace xt
         }
         size_type nbrows = ex.shape()[0], nbcols = ex.shape()[1];
         auto st = ex.stepper_begin(ex.shape());
+        detail::xtext_writer writer(stream);
         for (size_type r = 0; r != nbrows; ++r)
         {
             for (size_type c = 0; c != nbcols; ++c)
             {
-                stream << *st;
+                writer.write_value(*st);
                 if (c != nbcols - 1)
                 {
                     st.step(1);
-                    stream << ',';
+                    writer.put(',');
                 }
                 else
                 {
                     st.reset(1);
                     st.step(0);
-                    stream << std::endl;
+                    writer.put('\n');
                 }
             }
         }
+        writer.flush();
+        stream.flush();
     }
 
-    struct xcsv_config
+    /************************************
+     * xcsv_block_reader implementation *
+     ************************************/
+
+    /**
+     * Builds a block reader over the given stream.
+     * @param stream the input stream containing the CSV encoded values
+     * @param block_rows the maximum number of rows of each block
+     * @param config the CSV options (delimiter, skip_rows, max_rows and comments)
+     */
+    template <class T, class A>
+    inline xcsv_block_reader<T, A>::xcsv_block_reader(std::istream& stream, size_type block_rows, const xcsv_config& config)
+        : m_stream(stream)
+        , m_block_rows(block_rows)
+        , m_config(config)
+        , m_block()
+        , m_nbcol(0)
+        , m_nhead(0)
+        , m_nbrow(0)
     {
-        char delimiter;
-        std::size_t skip_rows;
-        std::ptrdiff_t max_rows;
-        std::string comments;
+        if (m_block_rows == 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "xcsv_block_reader: block_rows must be strictly positive");
+        }
+    }
 
-        xcsv_config()
-            : delimiter(',')
-            , skip_rows(0)
-            , max_rows(-1)
-            , comments("#")
+    /**
+     * Parses the next block of rows into the internal buffer.
+     * The previous block is overwritten, therefore references
+     * to its elements should not be held across calls to next.
+     * @return false if the stream has been exhausted or max_rows
+     * rows have been read, true otherwise.
+     */
+    template <class T, class A>
+    inline bool xcsv_block_reader<T, A>::next()
+    {
+        if (0 < m_config.max_rows && m_config.max_rows <= static_cast<const long long>(m_nbrow))
         {
+            return false;
         }
-    };
+        storage_type& data = m_block.storage();
+        data.clear();
+        size_type nbrow = 0;
+        output_iterator output(data);
+        while (nbrow < m_block_rows && std::getline(m_stream, m_row))
+        {
+            if (m_nhead < m_config.skip_rows)
+            {
+                ++m_nhead;
+                continue;
+            }
+            if (std::equal(m_config.comments.begin(), m_config.comments.end(), m_row.begin()))
+            {
+                continue;
+            }
+            std::stringstream row_stream(m_row);
+            size_type nbcol = detail::load_csv_row<size_type, T, output_iterator>(row_stream, output, m_cell, m_config.delimiter);
+            if (m_nbrow == 0)
+            {
+                m_nbcol = nbcol;
+            }
+            else if (nbcol != m_nbcol)
+            {
+                XTENSOR_THROW(std::runtime_error, "Inconsistent row lengths in CSV");
+            }
+            ++nbrow;
+            ++m_nbrow;
+            if (0 < m_config.max_rows && m_config.max_rows <= static_cast<const long long>(m_nbrow))
+            {
+                break;
+            }
+        }
+        if (nbrow == 0)
+        {
+            return false;
+        }
+        // The buffer already holds nbrow * m_nbcol elements, resize only
+        // updates the shape and the strides.
+        inner_shape_type shape = {nbrow, m_nbcol};
+        m_block.resize(shape);
+        return true;
+    }
+
+    /**
+     * Returns the last block parsed by next.
+     */
+    template <class T, class A>
+    inline auto xcsv_block_reader<T, A>::block() const noexcept -> const block_type&
+    {
+        return m_block;
+    }
+
+    /**
+     * Returns the total number of rows read so far, skipped
+     * rows and comments excluded.
+     */
+    template <class T, class A>
+    inline auto xcsv_block_reader<T, A>::rows_read() const noexcept -> size_type
+    {
+        return m_nbrow;
+    }
+
+    /**
+     * @brief Load tensor from CSV by blocks of rows.
+     *
+     * Parses the stream by blocks of at most \c block_rows rows and calls \c f
+     * on each block. The blocks share the same buffer, so \c f should copy
+     * the data it needs to keep.
+     * @param stream the input stream containing the CSV encoded values
+     * @param block_rows the maximum number of rows of each block
+     * @param f the callable invoked with each block, as a const xcsv_tensor<T, A>&
+     * @param config the CSV options (delimiter, skip_rows, max_rows and comments)
+     * @return the total number of rows read
+     */
+    template <class T, class A, class F>
+    inline std::size_t load_csv_blocks(std::istream& stream, std::size_t block_rows, F&& f, const xcsv_config& config)
+    {
+        xcsv_block_reader<T, A> reader(stream, block_rows, config);
+        while (reader.next())
+        {
+            f(reader.block());
+        }
+        return reader.rows_read();
+    }
 
     template <class E>
     void load_file(std::istream& stream, xexpression<E>& e, const xcsv_config& config)
@@ -226,6 +410,12 @@ namespace xt
     {
         dump_csv(stream, e);
     }
+
+    template <class T, class F>
+    std::size_t load_file_blocks(std::istream& stream, std::size_t block_rows, F&& f, const xcsv_config& config)
+    {
+        return load_csv_blocks<T>(stream, block_rows, std::forward<F>(f), config);
+    }
 }
 
 #endif
@@ -17,6 +17,9 @@ namespace xt
         template <class ET>
         void read(ET& array, const std::string& path, bool throw_on_fail = false) const;
 
+        template <class T, class F>
+        std::size_t read_blocks(const std::string& path, std::size_t block_rows, F&& f) const;
+
         void configure_format(const C& format_config);
 
     private:
@@ -62,6 +65,18 @@ namespace xt
         }
     }
 
+    template <class C>
+    template <class T, class F>
+    inline std::size_t xdisk_io_handler<C>::read_blocks(const std::string& path, std::size_t block_rows, F&& f) const
+    {
+        std::ifstream in_file(path, std::ifstream::binary);
+        if (!in_file.is_open())
+        {
+            XTENSOR_THROW(std::runtime_error, "read_blocks: failed to open file " + path);
+        }
+        return load_file_blocks<T>(in_file, block_rows, std::forward<F>(f), m_format_config);
+    }
+
     template <class C>
     inline void xdisk_io_handler<C>::configure_format(const C& format_config)
     {
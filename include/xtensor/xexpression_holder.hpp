@@ -53,9 +53,16 @@ namespace xt
         void to_json(nlohmann::json&) const;
         void from_json(const nlohmann::json&);
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        void to_json_typed_array(nlohmann::json&) const;
+#endif
+
     private:
 
         void init_pointer_from_json(const nlohmann::json&);
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        void init_pointer_from_json_typed_array(const nlohmann::json&);
+#endif
         void check_holder() const;
 
         std::unique_ptr<implementation_type> p_holder;
@@ -84,6 +91,9 @@ namespace xt
             virtual xexpression_holder_impl* clone() const = 0;
             virtual void to_json(nlohmann::json&) const = 0;
             virtual void from_json(const nlohmann::json&) = 0;
+#if defined(XTENSOR_JSON_HAS_BINARY)
+            virtual void to_json_typed_array(nlohmann::json&) const = 0;
+#endif
             virtual ~xexpression_holder_impl() = default;
 
         protected:
@@ -103,6 +113,9 @@ namespace xt
 
             void to_json(nlohmann::json&) const;
             void from_json(const nlohmann::json&);
+#if defined(XTENSOR_JSON_HAS_BINARY)
+            void to_json_typed_array(nlohmann::json&) const;
+#endif
 
             ~xexpression_wrapper() = default;
 
@@ -112,6 +125,11 @@ namespace xt
 
         private:
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+            void to_json_typed_array_impl(nlohmann::json&, std::true_type) const;
+            void to_json_typed_array_impl(nlohmann::json&, std::false_type) const;
+#endif
+
             CTE m_expression;
         };
     }
@@ -164,8 +182,35 @@ namespace xt
         p_holder->to_json(j);
     }
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    /**
+     * Serializes the held expression with the typed array encoding of
+     * \ref xt::to_json_typed_array when its value type is arithmetic,
+     * and with the nested arrays encoding otherwise.
+     */
+    inline void xexpression_holder::to_json_typed_array(nlohmann::json& j) const
+    {
+        if (p_holder == nullptr)
+        {
+            return;
+        }
+        p_holder->to_json_typed_array(j);
+    }
+#endif
+
     inline void xexpression_holder::from_json(const nlohmann::json& j)
     {
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        if (is_json_typed_array(j))
+        {
+            if (p_holder == nullptr)
+            {
+                init_pointer_from_json_typed_array(j);
+            }
+            p_holder->from_json(j);
+            return;
+        }
+#endif
         if (!j.is_array())
         {
             XTENSOR_THROW(std::runtime_error, "Received a JSON that does not contain a tensor");
@@ -206,6 +251,17 @@ namespace xt
         XTENSOR_THROW(std::runtime_error, "Received a JSON with a tensor that contains unsupported data type");
     }
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    inline void xexpression_holder::init_pointer_from_json_typed_array(const nlohmann::json& j)
+    {
+        detail::dispatch_json_dtype(j.at("dtype").get<std::string>(), [this](auto tag) {
+            using value_type = typename decltype(tag)::type;
+            xt::xarray<value_type> empty_arr;
+            p_holder.reset(new detail::xexpression_wrapper<xt::xarray<value_type>>(std::move(empty_arr)));
+        });
+    }
+#endif
+
     inline void xexpression_holder::check_holder() const
     {
         if (p_holder == nullptr)
@@ -258,6 +314,27 @@ namespace xt
             ::xt::from_json(j, m_expression);
         }
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        template <class CTE>
+        inline void xexpression_wrapper<CTE>::to_json_typed_array(nlohmann::json& j) const
+        {
+            using value_type = std::decay_t<typename std::decay_t<CTE>::value_type>;
+            to_json_typed_array_impl(j, json_typed_array_value<value_type>());
+        }
+
+        template <class CTE>
+        inline void xexpression_wrapper<CTE>::to_json_typed_array_impl(nlohmann::json& j, std::true_type) const
+        {
+            ::xt::to_json_typed_array(j, m_expression);
+        }
+
+        template <class CTE>
+        inline void xexpression_wrapper<CTE>::to_json_typed_array_impl(nlohmann::json& j, std::false_type) const
+        {
+            ::xt::to_json(j, m_expression);
+        }
+#endif
+
         template <class CTE>
         inline xexpression_wrapper<CTE>::xexpression_wrapper(const xexpression_wrapper& wrapper)
             : xexpression_holder_impl(),
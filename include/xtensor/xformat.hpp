@@ -0,0 +1,495 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FORMAT_HPP
+#define XTENSOR_FORMAT_HPP
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ios>
+#include <limits>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__has_include)
+#if __cplusplus >= 201703L && __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define XTENSOR_HAS_FLOATING_TO_CHARS
+#endif
+
+namespace xt
+{
+    namespace detail
+    {
+        /*********************
+         * integer formatter *
+         *********************/
+
+        inline const char* digit_pairs() noexcept
+        {
+            static const char pairs[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+            return pairs;
+        }
+
+        template <class T>
+        inline bool is_negative(T value, std::true_type /*is_signed*/) noexcept
+        {
+            return value < T(0);
+        }
+
+        template <class T>
+        inline bool is_negative(T, std::false_type /*is_signed*/) noexcept
+        {
+            return false;
+        }
+
+        /**
+         * Writes the decimal representation of an integral value
+         * at \c first and returns the past-the-end pointer of the written
+         * characters. \c first must point to at least 21 characters.
+         */
+        template <class T>
+        inline char* format_integer(char* first, T value) noexcept
+        {
+            static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                          "format_integer requires a non boolean integral type");
+            using unsigned_type = std::make_unsigned_t<T>;
+            using work_type = std::conditional_t<(sizeof(T) > sizeof(std::uint32_t)), std::uint64_t, std::uint32_t>;
+
+            work_type uvalue = static_cast<work_type>(static_cast<unsigned_type>(value));
+            if (is_negative(value, std::is_signed<T>()))
+            {
+                *first++ = '-';
+                uvalue = static_cast<work_type>(unsigned_type(0) - static_cast<unsigned_type>(value));
+            }
+
+            const char* pairs = digit_pairs();
+            char buffer[std::numeric_limits<std::uint64_t>::digits10 + 1];
+            char* last = buffer + sizeof(buffer);
+            char* it = last;
+            while (uvalue >= 100u)
+            {
+                std::size_t index = static_cast<std::size_t>(uvalue % 100u) * 2u;
+                uvalue /= 100u;
+                *--it = pairs[index + 1];
+                *--it = pairs[index];
+            }
+            if (uvalue >= 10u)
+            {
+                std::size_t index = static_cast<std::size_t>(uvalue) * 2u;
+                *--it = pairs[index + 1];
+                *--it = pairs[index];
+            }
+            else
+            {
+                *--it = static_cast<char>('0' + uvalue);
+            }
+            return std::copy(it, last, first);
+        }
+
+        /*****************************
+         * floating point formatters *
+         *****************************/
+
+        // The C library formats and parses floating point values according
+        // to the global C locale, the functions below fall back to streams
+        // imbued with the classic locale when its decimal point is not '.'
+        // so that the text does not depend on the locale.
+        inline bool is_classic_c_numeric() noexcept
+        {
+            const char* point = std::localeconv()->decimal_point;
+            return point[0] == '.' && point[1] == '\0';
+        }
+
+        // Same as std::snprintf with the "%*.*" format of the floatfield
+        template <class T>
+        inline int format_classic(char* first, std::size_t size, int width, int precision,
+                                  std::ios_base::fmtflags floatfield, T value)
+        {
+            std::ostringstream stream;
+            stream.imbue(std::locale::classic());
+            stream.setf(floatfield, std::ios_base::floatfield);
+            stream.width(width);
+            stream.precision(precision);
+            stream << value;
+            std::string res = stream.str();
+            if (size != 0)
+            {
+                std::size_t n = std::min(res.size(), size - 1);
+                std::copy(res.data(), res.data() + n, first);
+                first[n] = '\0';
+            }
+            return static_cast<int>(res.size());
+        }
+
+        template <class T>
+        inline T parse_classic(const char* str)
+        {
+            std::istringstream stream(str);
+            stream.imbue(std::locale::classic());
+            T res = T(0);
+            stream >> res;
+            return res;
+        }
+
+        inline int format_general(char* first, std::size_t size, int precision, double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%.*g", precision, value)
+                                          : format_classic(first, size, 0, precision, std::ios_base::fmtflags(0), value);
+        }
+
+        inline int format_general(char* first, std::size_t size, int precision, long double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%.*Lg", precision, value)
+                                          : format_classic(first, size, 0, precision, std::ios_base::fmtflags(0), value);
+        }
+
+        inline float parse_floating(const char* str, float)
+        {
+            return is_classic_c_numeric() ? std::strtof(str, nullptr) : parse_classic<float>(str);
+        }
+
+        inline double parse_floating(const char* str, double)
+        {
+            return is_classic_c_numeric() ? std::strtod(str, nullptr) : parse_classic<double>(str);
+        }
+
+        inline long double parse_floating(const char* str, long double)
+        {
+            return is_classic_c_numeric() ? std::strtold(str, nullptr) : parse_classic<long double>(str);
+        }
+
+        template <class T>
+        inline char* format_shortest_fallback(char* first, char* last, T value)
+        {
+            using promoted_type = std::conditional_t<std::is_same<T, long double>::value, long double, double>;
+            // Any normal value with at most digits10 significant digits is
+            // exactly represented by %g with that precision, therefore the first
+            // precision that round-trips gives the shortest representation.
+            // Subnormal values have fewer significant digits and are searched
+            // from the lowest precision.
+            int res = 0;
+            int min_precision = std::fpclassify(value) == FP_SUBNORMAL ? 1 : std::numeric_limits<T>::digits10;
+            for (int precision = min_precision; precision <= std::numeric_limits<T>::max_digits10; ++precision)
+            {
+                res = format_general(first, static_cast<std::size_t>(last - first), precision, static_cast<promoted_type>(value));
+                if (parse_floating(first, value) == value)
+                {
+                    break;
+                }
+            }
+            return first + std::min(static_cast<std::ptrdiff_t>(res), last - first - 1);
+        }
+
+        /**
+         * Writes the shortest representation of \c value that parses back
+         * to the same value, and returns the past-the-end pointer of the
+         * written characters. The range [first, last) should hold at least
+         * 32 characters.
+         */
+        template <class T>
+        inline char* format_shortest(char* first, char* last, T value)
+        {
+            static_assert(std::is_floating_point<T>::value, "format_shortest requires a floating point type");
+#if defined(XTENSOR_HAS_FLOATING_TO_CHARS)
+            auto res = std::to_chars(first, last, value);
+            if (res.ec == std::errc())
+            {
+                return res.ptr;
+            }
+#endif
+            return format_shortest_fallback(first, last, value);
+        }
+
+        inline int format_fixed(char* first, std::size_t size, int width, int precision, double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%*.*f", width, precision, value)
+                                          : format_classic(first, size, width, precision, std::ios_base::fixed, value);
+        }
+
+        inline int format_fixed(char* first, std::size_t size, int width, int precision, long double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%*.*Lf", width, precision, value)
+                                          : format_classic(first, size, width, precision, std::ios_base::fixed, value);
+        }
+
+        inline int format_scientific(char* first, std::size_t size, int width, int precision, double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%*.*e", width, precision, value)
+                                          : format_classic(first, size, width, precision, std::ios_base::scientific, value);
+        }
+
+        inline int format_scientific(char* first, std::size_t size, int width, int precision, long double value)
+        {
+            return is_classic_c_numeric() ? std::snprintf(first, size, "%*.*Le", width, precision, value)
+                                          : format_classic(first, size, width, precision, std::ios_base::scientific, value);
+        }
+
+        /****************
+         * xtext_writer *
+         ****************/
+
+        template <class T>
+        struct is_text_integral
+            : std::integral_constant<bool, std::is_integral<T>::value &&
+                                           !std::is_same<T, bool>::value &&
+                                           !std::is_same<T, char>::value &&
+                                           !std::is_same<T, signed char>::value &&
+                                           !std::is_same<T, unsigned char>::value &&
+                                           !std::is_same<T, wchar_t>::value &&
+                                           !std::is_same<T, char16_t>::value &&
+                                           !std::is_same<T, char32_t>::value>
+        {
+        };
+
+        /**
+         * Buffered text writer: values are formatted into a char buffer
+         * that is written to the underlying stream by large chunks.
+         * Integral and floating point values bypass the iostream
+         * formatting; other types fall back to operator<<.
+         */
+        class xtext_writer
+        {
+        public:
+
+            explicit xtext_writer(std::ostream& out, std::size_t capacity = 65536);
+            ~xtext_writer();
+
+            xtext_writer(const xtext_writer&) = delete;
+            xtext_writer& operator=(const xtext_writer&) = delete;
+
+            void put(char c);
+            void write(const char* s, std::size_t n);
+
+            template <class T>
+            void write_value(const T& value);
+
+            void flush();
+
+        private:
+
+            static constexpr std::size_t max_value_size = 64;
+
+            template <class T>
+            void write_value_impl(const T& value, std::true_type /*integral*/, std::false_type /*floating*/);
+
+            template <class T>
+            void write_value_impl(const T& value, std::false_type /*integral*/, std::true_type /*floating*/);
+
+            template <class T>
+            void write_value_impl(const T& value, std::false_type /*integral*/, std::false_type /*floating*/);
+
+            void reserve(std::size_t n);
+
+            std::ostream& m_out;
+            std::vector<char> m_buffer;
+            std::size_t m_size;
+        };
+
+        /***********************
+         * xbuffered_streambuf *
+         ***********************/
+
+        /**
+         * Stream buffer accumulating characters in a large buffer before
+         * forwarding them to a target stream buffer, so that many small
+         * insertions result in few writes.
+         */
+        class xbuffered_streambuf : public std::streambuf
+        {
+        public:
+
+            explicit xbuffered_streambuf(std::streambuf* target, std::size_t capacity = 65536);
+            ~xbuffered_streambuf() override;
+
+            xbuffered_streambuf(const xbuffered_streambuf&) = delete;
+            xbuffered_streambuf& operator=(const xbuffered_streambuf&) = delete;
+
+        protected:
+
+            int_type overflow(int_type ch) override;
+            std::streamsize xsputn(const char_type* s, std::streamsize n) override;
+            int sync() override;
+
+        private:
+
+            bool flush_buffer();
+
+            std::streambuf* p_target;
+            std::vector<char> m_buffer;
+        };
+
+        /*******************************
+         * xtext_writer implementation *
+         *******************************/
+
+        inline xtext_writer::xtext_writer(std::ostream& out, std::size_t capacity)
+            : m_out(out), m_buffer(std::max(capacity, 2 * max_value_size)), m_size(0)
+        {
+        }
+
+        inline xtext_writer::~xtext_writer()
+        {
+            flush();
+        }
+
+        inline void xtext_writer::put(char c)
+        {
+            reserve(1);
+            m_buffer[m_size++] = c;
+        }
+
+        inline void xtext_writer::write(const char* s, std::size_t n)
+        {
+            if (n > m_buffer.size() - m_size)
+            {
+                flush();
+                if (n > m_buffer.size())
+                {
+                    m_out.write(s, static_cast<std::streamsize>(n));
+                    return;
+                }
+            }
+            std::copy(s, s + n, m_buffer.data() + m_size);
+            m_size += n;
+        }
+
+        template <class T>
+        inline void xtext_writer::write_value(const T& value)
+        {
+            write_value_impl(value, is_text_integral<T>(), std::is_floating_point<T>());
+        }
+
+        inline void xtext_writer::flush()
+        {
+            if (m_size != 0)
+            {
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+                m_size = 0;
+            }
+        }
+
+        template <class T>
+        inline void xtext_writer::write_value_impl(const T& value, std::true_type, std::false_type)
+        {
+            reserve(max_value_size);
+            char* first = m_buffer.data() + m_size;
+            m_size += static_cast<std::size_t>(format_integer(first, value) - first);
+        }
+
+        template <class T>
+        inline void xtext_writer::write_value_impl(const T& value, std::false_type, std::true_type)
+        {
+            reserve(max_value_size);
+            char* first = m_buffer.data() + m_size;
+            m_size += static_cast<std::size_t>(format_shortest(first, first + max_value_size, value) - first);
+        }
+
+        template <class T>
+        inline void xtext_writer::write_value_impl(const T& value, std::false_type, std::false_type)
+        {
+            flush();
+            m_out << value;
+        }
+
+        inline void xtext_writer::reserve(std::size_t n)
+        {
+            if (m_buffer.size() - m_size < n)
+            {
+                flush();
+            }
+        }
+
+        /**************************************
+         * xbuffered_streambuf implementation *
+         **************************************/
+
+        inline xbuffered_streambuf::xbuffered_streambuf(std::streambuf* target, std::size_t capacity)
+            : p_target(target), m_buffer(std::max(capacity, std::size_t(1)))
+        {
+            setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        }
+
+        inline xbuffered_streambuf::~xbuffered_streambuf()
+        {
+            flush_buffer();
+        }
+
+        inline auto xbuffered_streambuf::overflow(int_type ch) -> int_type
+        {
+            if (!flush_buffer())
+            {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        inline std::streamsize xbuffered_streambuf::xsputn(const char_type* s, std::streamsize n)
+        {
+            if (n > epptr() - pptr())
+            {
+                if (!flush_buffer())
+                {
+                    return 0;
+                }
+                if (n > epptr() - pptr())
+                {
+                    return p_target->sputn(s, n);
+                }
+            }
+            std::copy(s, s + n, pptr());
+            pbump(static_cast<int>(n));
+            return n;
+        }
+
+        inline int xbuffered_streambuf::sync()
+        {
+            return flush_buffer() ? p_target->pubsync() : -1;
+        }
+
+        inline bool xbuffered_streambuf::flush_buffer()
+        {
+            std::streamsize n = pptr() - pbase();
+            bool res = n == 0 || p_target->sputn(pbase(), n) == n;
+            setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+            return res;
+        }
+    }
+}
+
+#endif
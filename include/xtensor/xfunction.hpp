@@ -314,6 +314,7 @@ namespace xt
                   std::size_t N = xt_simd::simd_traits<requested_type>::size>
         simd_return_type<requested_type> load_simd(size_type i) const;
 
+        tuple_type& arguments() noexcept;
         const tuple_type& arguments() const noexcept;
 
         const functor_type& functor() const noexcept;
@@ -754,6 +755,12 @@ namespace xt
         return load_simd_impl<align, requested_type, N>(std::make_index_sequence<sizeof...(CT)>(), i);
     }
 
+    template <class F, class... CT>
+    inline auto xfunction<F, CT...>::arguments() noexcept -> tuple_type&
+    {
+        return m_e;
+    }
+
     template <class F, class... CT>
     inline auto xfunction<F, CT...>::arguments() const noexcept -> const tuple_type&
     {
@@ -0,0 +1,378 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HUGE_PAGE_ALLOCATOR_HPP
+#define XTENSOR_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(XTENSOR_USE_NUMA)
+#include <numaif.h>
+#endif
+
+#include "xtensor_config.hpp"
+
+// Size in bytes from which blocks are mapped on huge pages
+#ifndef XTENSOR_HUGE_PAGE_THRESHOLD
+#define XTENSOR_HUGE_PAGE_THRESHOLD (std::size_t(1) << 21)
+#endif
+
+namespace xt
+{
+    /**
+     * NUMA placement of the blocks allocated by huge_page_allocator.
+     */
+    enum class numa_policy
+    {
+        /// pages are placed on the node of the thread that first writes them
+        first_touch,
+        /// pages are interleaved across all the nodes (requires XTENSOR_USE_NUMA)
+        interleave
+    };
+
+    namespace detail
+    {
+#if defined(XTENSOR_USE_NUMA)
+        constexpr bool huge_page_numa_support = true;
+#else
+        constexpr bool huge_page_numa_support = false;
+#endif
+    }
+
+    /***********************
+     * huge_page_allocator *
+     ***********************/
+
+    /**
+     * @class huge_page_allocator
+     * @brief Allocator for large buffers backed by huge pages.
+     *
+     * On Linux, blocks of at least XTENSOR_HUGE_PAGE_THRESHOLD bytes are
+     * mapped directly, aligned on and rounded up to a multiple of the huge
+     * page size, and advised as huge page candidates (MADV_HUGEPAGE), so
+     * that they can be backed by huge pages from their start, which reduces
+     * TLB misses on large arrays. Smaller blocks, and all blocks on other
+     * platforms, are allocated on the heap with a 64 bytes alignment.
+     *
+     * The mapped pages are not touched by the allocator: with the
+     * first_touch policy, they are placed on the NUMA node of the thread
+     * that writes them first. Assigning an expression (for instance
+     * xt::zeros) to a container using this allocator with XTENSOR_USE_TBB
+     * or XTENSOR_USE_OPENMP defined initializes it in parallel, so that
+     * the pages are spread across the nodes of the workers. With the
+     * interleave policy, the pages are interleaved across all the nodes
+     * the process may allocate memory on; this requires XTENSOR_USE_NUMA
+     * and linking with libnuma, and the allocator throws std::runtime_error
+     * if the policy cannot be applied.
+     *
+     * The allocator also provides a reallocate method, used by uvector
+     * to grow buffers of trivial elements: on Linux, mapped blocks are
+     * extended with mremap, which avoids copying them.
+     *
+     * @tparam T the type of the allocated elements.
+     * @tparam P the NUMA placement policy.
+     */
+    template <class T, numa_policy P = numa_policy::first_touch>
+    class huge_page_allocator
+    {
+    public:
+
+        static_assert(P != numa_policy::interleave || detail::huge_page_numa_support,
+                      "numa_policy::interleave requires XTENSOR_USE_NUMA");
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U, P>;
+        };
+
+        huge_page_allocator() noexcept = default;
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U, P>&) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+        T* reallocate(T* p, std::size_t old_n, std::size_t new_n);
+    };
+
+    template <class T, class U, numa_policy P>
+    bool operator==(const huge_page_allocator<T, P>&, const huge_page_allocator<U, P>&) noexcept;
+
+    template <class T, class U, numa_policy P>
+    bool operator!=(const huge_page_allocator<T, P>&, const huge_page_allocator<U, P>&) noexcept;
+
+    /**************************************
+     * huge_page_allocator implementation *
+     **************************************/
+
+    namespace detail
+    {
+        constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+        constexpr std::size_t huge_page_alignment = 64;
+
+        inline std::size_t huge_page_length(std::size_t size) noexcept
+        {
+            return (size + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+
+        inline bool use_huge_pages(std::size_t size) noexcept
+        {
+#if defined(__linux__)
+            return size >= XTENSOR_HUGE_PAGE_THRESHOLD;
+#else
+            (void)size;
+            return false;
+#endif
+        }
+
+        inline void* huge_page_heap_allocate(std::size_t size)
+        {
+            char* raw = static_cast<char*>(::operator new(size + huge_page_alignment));
+            std::size_t shift = huge_page_alignment - reinterpret_cast<std::uintptr_t>(raw) % huge_page_alignment;
+            char* res = raw + shift;
+            res[-1] = static_cast<char>(shift - 1);
+            return res;
+        }
+
+        inline void huge_page_heap_deallocate(void* p) noexcept
+        {
+            char* res = static_cast<char*>(p);
+            std::size_t shift = static_cast<std::size_t>(static_cast<unsigned char>(res[-1])) + 1;
+            ::operator delete(res - shift);
+        }
+
+        // Maps length bytes aligned on the huge page size: the mapping is
+        // one huge page larger than needed, and the slack is unmapped.
+        // Returns nullptr on failure.
+        inline void* huge_page_map_aligned(std::size_t length) noexcept
+        {
+#if defined(__linux__)
+            std::size_t mapped = length + huge_page_size;
+            void* raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            char* first = static_cast<char*>(raw);
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(first);
+            char* res = first + (((addr + huge_page_size - 1) & ~(huge_page_size - 1)) - addr);
+            std::size_t head = static_cast<std::size_t>(res - first);
+            if (head != 0)
+            {
+                munmap(first, head);
+            }
+            if (mapped - head != length)
+            {
+                munmap(res + length, mapped - head - length);
+            }
+            return res;
+#else
+            (void)length;
+            return nullptr;
+#endif
+        }
+
+        [[noreturn]] inline void huge_page_fail(const char* msg)
+        {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+            (void)msg;
+            std::abort();
+#else
+            if (msg == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            throw std::runtime_error(msg);
+#endif
+        }
+
+        // Returns false if the policy could not be applied. Interleaving
+        // uses the nodes the process is allowed to allocate memory on.
+        inline bool huge_page_bind(void* p, std::size_t length, numa_policy policy) noexcept
+        {
+#if defined(XTENSOR_USE_NUMA)
+            if (policy == numa_policy::interleave)
+            {
+                constexpr std::size_t max_nodes = 1024;
+                constexpr std::size_t bits = sizeof(unsigned long) * 8;
+                unsigned long mask[max_nodes / bits] = {};
+                if (get_mempolicy(nullptr, mask, max_nodes, nullptr, MPOL_F_MEMS_ALLOWED) != 0)
+                {
+                    return false;
+                }
+                return mbind(p, length, MPOL_INTERLEAVE, mask, max_nodes, 0) == 0;
+            }
+            return true;
+#else
+            (void)p;
+            (void)length;
+            (void)policy;
+            return true;
+#endif
+        }
+
+        inline void* huge_page_map(std::size_t size, numa_policy policy)
+        {
+#if defined(__linux__)
+            std::size_t length = huge_page_length(size);
+            void* p = huge_page_map_aligned(length);
+            if (p == nullptr)
+            {
+                huge_page_fail(nullptr);
+            }
+#if defined(MADV_HUGEPAGE)
+            // Only a hint: transparent huge pages may be disabled
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+            if (!huge_page_bind(p, length, policy))
+            {
+                munmap(p, length);
+                huge_page_fail("huge_page_allocator: cannot apply the NUMA policy");
+            }
+            return p;
+#else
+            (void)policy;
+            return huge_page_heap_allocate(size);
+#endif
+        }
+
+        // The block is extended in place if possible; otherwise its pages
+        // are moved, without copying them, to a new range aligned on the
+        // huge page size. In both cases, the mapping keeps its advice and
+        // its NUMA policy.
+        inline void* huge_page_remap(void* p, std::size_t old_size, std::size_t new_size)
+        {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE) && defined(MREMAP_FIXED)
+            std::size_t old_length = huge_page_length(old_size);
+            std::size_t new_length = huge_page_length(new_size);
+            if (old_length == new_length)
+            {
+                return p;
+            }
+            void* res = mremap(p, old_length, new_length, 0);
+            if (res == MAP_FAILED)
+            {
+                void* target = huge_page_map_aligned(new_length);
+                if (target == nullptr)
+                {
+                    huge_page_fail(nullptr);
+                }
+                res = mremap(p, old_length, new_length, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+                if (res == MAP_FAILED)
+                {
+                    munmap(target, new_length);
+                    huge_page_fail(nullptr);
+                }
+            }
+            return res;
+#else
+            (void)p;
+            (void)old_size;
+            (void)new_size;
+            return nullptr;
+#endif
+        }
+
+        inline void huge_page_unmap(void* p, std::size_t size) noexcept
+        {
+#if defined(__linux__)
+            munmap(p, huge_page_length(size));
+#else
+            (void)size;
+            huge_page_heap_deallocate(p);
+#endif
+        }
+    }
+
+    template <class T, numa_policy P>
+    template <class U>
+    inline huge_page_allocator<T, P>::huge_page_allocator(const huge_page_allocator<U, P>&) noexcept
+    {
+    }
+
+    template <class T, numa_policy P>
+    inline T* huge_page_allocator<T, P>::allocate(std::size_t n)
+    {
+        std::size_t size = n * sizeof(T);
+        void* p = detail::use_huge_pages(size) ? detail::huge_page_map(size, P)
+                                               : detail::huge_page_heap_allocate(size);
+        return static_cast<T*>(p);
+    }
+
+    template <class T, numa_policy P>
+    inline void huge_page_allocator<T, P>::deallocate(T* p, std::size_t n) noexcept
+    {
+        if (p == nullptr)
+        {
+            return;
+        }
+        std::size_t size = n * sizeof(T);
+        if (detail::use_huge_pages(size))
+        {
+            detail::huge_page_unmap(p, size);
+        }
+        else
+        {
+            detail::huge_page_heap_deallocate(p);
+        }
+    }
+
+    template <class T, numa_policy P>
+    inline T* huge_page_allocator<T, P>::reallocate(T* p, std::size_t old_n, std::size_t new_n)
+    {
+        std::size_t old_size = old_n * sizeof(T);
+        std::size_t new_size = new_n * sizeof(T);
+        if (detail::use_huge_pages(old_size) && detail::use_huge_pages(new_size))
+        {
+            void* res = detail::huge_page_remap(p, old_size, new_size);
+            if (res != nullptr)
+            {
+                return static_cast<T*>(res);
+            }
+        }
+        T* res = allocate(new_n);
+        std::memcpy(res, p, (old_n < new_n ? old_n : new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return res;
+    }
+
+    template <class T, class U, numa_policy P>
+    inline bool operator==(const huge_page_allocator<T, P>&, const huge_page_allocator<U, P>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, numa_policy P>
+    inline bool operator!=(const huge_page_allocator<T, P>&, const huge_page_allocator<U, P>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
@@ -10,15 +10,18 @@
 #ifndef XTENSOR_IO_HPP
 #define XTENSOR_IO_HPP
 
+#include <algorithm>
 #include <complex>
 #include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <locale>
 #include <numeric>
 #include <sstream>
 #include <string>
 
 #include "xexpression.hpp"
+#include "xformat.hpp"
 #include "xmath.hpp"
 #include "xstrided_view.hpp"
 
@@ -185,15 +188,21 @@ namespace xt
 
     namespace detail
     {
-        template <class E, class F>
-        std::ostream& xoutput(std::ostream& out, const E& e,
-                              xstrided_slice_vector& slices, F& printer, std::size_t blanks,
-                              std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
+        // The summarizing printer only visits the edge items of each
+        // dimension: elements are accessed through element() with an
+        // index computed from the shape, and the layout is computed from
+        // the shape only, so that printing a lazy expression never evaluates
+        // the elements that are not displayed.
+
+        template <class S, class F>
+        std::ostream& xoutput_impl(std::ostream& out, const S& shape, std::size_t axis,
+                                   F& printer, std::size_t blanks,
+                                   std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
         {
-            using size_type = typename E::size_type;
+            using size_type = std::size_t;
 
-            const auto view = xt::strided_view(e, slices);
-            if (view.dimension() == 0)
+            size_type dimension = shape.size() - axis;
+            if (dimension == 0)
             {
                 printer.print_next(out);
             }
@@ -205,33 +214,32 @@ namespace xt
                 size_type elems_on_line = 0;
                 size_type ewp2 = static_cast<size_type>(element_width) + size_type(2);
                 size_type line_lim = static_cast<size_type>(std::floor(line_width / ewp2));
+                size_type nrows = static_cast<size_type>(shape[axis]);
 
                 out << '{';
-                for (; i != size_type(view.shape()[0] - 1); ++i)
+                for (; i != nrows - 1; ++i)
                 {
-                    if (edgeitems && size_type(view.shape()[0]) > (edgeitems * 2) && i == edgeitems)
+                    if (edgeitems && nrows > (edgeitems * 2) && i == edgeitems)
                     {
                         out << "..., ";
-                        if (view.dimension() > 1)
+                        if (dimension > 1)
                         {
                             elems_on_line = 0;
                             out << std::endl
                                 << indents;
                         }
-                        i = size_type(view.shape()[0]) - edgeitems;
+                        i = nrows - edgeitems;
                     }
-                    if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                    if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                     {
                         out << std::endl
                             << indents;
                         elems_on_line = 0;
                     }
-                    slices.push_back(static_cast<int>(i));
-                    xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << ',';
-                    slices.pop_back();
+                    xoutput_impl(out, shape, axis + 1, printer, blanks + 1, element_width, edgeitems, line_width) << ',';
                     elems_on_line++;
 
-                    if (view.dimension() == 1)
+                    if (dimension == 1)
                     {
                         out << ' ';
                     }
@@ -241,46 +249,88 @@ namespace xt
                             << indents;
                     }
                 }
-                if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                 {
                     out << std::endl
                         << indents;
                 }
-                slices.push_back(static_cast<int>(i));
-                xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << '}';
-                slices.pop_back();
+                xoutput_impl(out, shape, axis + 1, printer, blanks + 1, element_width, edgeitems, line_width) << '}';
             }
             return out;
         }
 
-        template <class F, class E>
-        static void recurser_run(F& fn, const E& e, xstrided_slice_vector& slices, std::size_t lim = 0)
+        template <class E, class F>
+        std::ostream& xoutput(std::ostream& out, const E& e,
+                              xstrided_slice_vector& slices, F& printer, std::size_t blanks,
+                              std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
+        {
+            if (slices.empty())
+            {
+                return xoutput_impl(out, e.shape(), 0, printer, blanks, element_width, edgeitems, line_width);
+            }
+            const auto view = xt::strided_view(e, slices);
+            return xoutput_impl(out, view.shape(), 0, printer, blanks, element_width, edgeitems, line_width);
+        }
+
+        template <class F, class E, class I>
+        void edge_recurser_run(F& fn, const E& e, I& index, std::size_t axis, std::size_t lim)
         {
-            using size_type = typename E::size_type;
-            const auto view = strided_view(e, slices);
-            if (view.dimension() == 0)
+            using size_type = typename I::value_type;
+            if (axis == index.size())
             {
-                fn.update(view());
+                fn.update(e.element(index.cbegin(), index.cend()));
             }
             else
             {
-                size_type i = 0;
-                for (; i != static_cast<size_type>(view.shape()[0] - 1); ++i)
+                size_type n = static_cast<size_type>(e.shape()[axis]);
+                for (size_type i = 0; i != n; ++i)
                 {
-                    if (lim && size_type(view.shape()[0]) > (lim * 2) && i == lim)
+                    if (lim && n > (lim * 2) && i == lim)
                     {
-                        i = static_cast<size_type>(view.shape()[0]) - lim;
+                        i = n - static_cast<size_type>(lim);
                     }
-                    slices.push_back(static_cast<int>(i));
-                    recurser_run(fn, e, slices, lim);
-                    slices.pop_back();
+                    index[axis] = i;
+                    edge_recurser_run(fn, e, index, axis + 1, lim);
                 }
-                slices.push_back(static_cast<int>(i));
-                recurser_run(fn, e, slices, lim);
-                slices.pop_back();
             }
         }
 
+        template <class F, class E>
+        void edge_recurser_run(F& fn, const E& e, std::size_t lim)
+        {
+            svector<typename E::size_type, 4> index(e.dimension(), 0);
+            edge_recurser_run(fn, e, index, 0, lim);
+        }
+
+        template <class F, class E>
+        static void recurser_run(F& fn, const E& e, xstrided_slice_vector& slices, std::size_t lim = 0)
+        {
+            if (slices.empty())
+            {
+                edge_recurser_run(fn, e, lim);
+            }
+            else
+            {
+                const auto view = strided_view(e, slices);
+                edge_recurser_run(fn, view, lim);
+            }
+        }
+
+        // Returns true if the flags and the locale of the stream do not
+        // alter the text of the numbers, which the printers then format
+        // without the stream. Their stream path formats the fixed notation
+        // with a stringstream, whose locale is the global one.
+        inline bool has_default_number_format(const std::ostream& out)
+        {
+            const std::ios_base::fmtflags flags = out.flags();
+            const std::ios_base::fmtflags altering = std::ios_base::showpos | std::ios_base::uppercase |
+                                                     std::ios_base::showbase | std::ios_base::showpoint |
+                                                     std::ios_base::hex | std::ios_base::oct;
+            return (flags & altering) == 0 &&
+                   out.getloc() == std::locale::classic() &&
+                   std::locale() == std::locale::classic();
+        }
+
         template <class T, class E = void>
         struct printer;
 
@@ -290,6 +340,7 @@ namespace xt
             using value_type = std::decay_t<typename T::value_type>;
             using cache_type = std::vector<value_type>;
             using cache_iterator = typename cache_type::const_iterator;
+            using format_type = std::conditional_t<std::is_same<value_type, long double>::value, long double, double>;
 
             explicit printer(std::streamsize precision)
                 : m_precision(precision)
@@ -324,54 +375,49 @@ namespace xt
                 {
                     --m_width;
                 }
+                // Fixed notation holds at most 8 integral digits, see update.
+                // The remaining room accounts for sign, dot, exponent, inf and nan.
+                m_buffer.resize(static_cast<std::size_t>(std::max(m_width, m_precision)) + 32u);
             }
 
             std::ostream& print_next(std::ostream& out)
             {
-                if (!m_scientific)
+                if (!m_stream_format_checked)
                 {
-                    std::stringstream buf;
-                    buf.width(m_width);
-                    buf << std::fixed;
-                    buf.precision(m_precision);
-                    buf << (*m_it);
+                    m_stream_format = !has_default_number_format(out);
+                    m_stream_format_checked = true;
+                }
+                if (m_stream_format)
+                {
+                    print_next_stream(out);
+                }
+                else if (!m_scientific)
+                {
+                    std::size_t size = static_cast<std::size_t>(detail::format_fixed(m_buffer.data(), m_buffer.size(),
+                                                                                     static_cast<int>(m_width),
+                                                                                     static_cast<int>(m_precision),
+                                                                                     static_cast<format_type>(*m_it)));
                     if (!m_required_precision && !std::isinf(*m_it) && !std::isnan(*m_it))
                     {
-                        buf << '.';
+                        m_buffer[size++] = '.';
                     }
-                    std::string res = buf.str();
-                    auto sit = res.rbegin();
-                    while (*sit == '0')
+                    for (std::size_t i = size; i != 0 && m_buffer[i - 1] == '0'; --i)
                     {
-                        *sit = ' ';
-                        ++sit;
+                        m_buffer[i - 1] = ' ';
                     }
-                    out << res;
+                    out.write(m_buffer.data(), static_cast<std::streamsize>(size));
+                }
+                else if (!m_large_exponent)
+                {
+                    std::size_t size = static_cast<std::size_t>(detail::format_scientific(m_buffer.data(), m_buffer.size(),
+                                                                                          static_cast<int>(m_width),
+                                                                                          static_cast<int>(m_precision),
+                                                                                          static_cast<format_type>(*m_it)));
+                    out.write(m_buffer.data(), static_cast<std::streamsize>(size));
                 }
                 else
                 {
-                    if (!m_large_exponent)
-                    {
-                        out << std::scientific;
-                        out.width(m_width);
-                        out << (*m_it);
-                    }
-                    else
-                    {
-                        std::stringstream buf;
-                        buf.width(m_width);
-                        buf << std::scientific;
-                        buf.precision(m_precision);
-                        buf << (*m_it);
-                        std::string res = buf.str();
-
-                        if (res[res.size() - 4] == 'e')
-                        {
-                            res.erase(0, 1);
-                            res.insert(res.size() - 2, "0");
-                        }
-                        out << res;
-                    }
+                    print_large_exponent(out);
                 }
                 ++m_it;
                 return out;
@@ -416,8 +462,62 @@ namespace xt
 
         private:
 
+            // Formats the current value with the flags and the locale of the stream
+            void print_next_stream(std::ostream& out)
+            {
+                if (!m_scientific)
+                {
+                    std::stringstream buf;
+                    buf.width(m_width);
+                    buf << std::fixed;
+                    buf.precision(m_precision);
+                    buf << (*m_it);
+                    if (!m_required_precision && !std::isinf(*m_it) && !std::isnan(*m_it))
+                    {
+                        buf << '.';
+                    }
+                    std::string res = buf.str();
+                    auto sit = res.rbegin();
+                    while (sit != res.rend() && *sit == '0')
+                    {
+                        *sit = ' ';
+                        ++sit;
+                    }
+                    out << res;
+                }
+                else if (!m_large_exponent)
+                {
+                    out << std::scientific;
+                    out.width(m_width);
+                    out << (*m_it);
+                }
+                else
+                {
+                    print_large_exponent(out);
+                }
+            }
+
+            void print_large_exponent(std::ostream& out)
+            {
+                std::stringstream buf;
+                buf.width(m_width);
+                buf << std::scientific;
+                buf.precision(m_precision);
+                buf << (*m_it);
+                std::string res = buf.str();
+
+                if (res[res.size() - 4] == 'e')
+                {
+                    res.erase(0, 1);
+                    res.insert(res.size() - 2, "0");
+                }
+                out << res;
+            }
+
             bool m_large_exponent = false;
             bool m_scientific = false;
+            bool m_stream_format = false;
+            bool m_stream_format_checked = false;
             std::streamsize m_width = 9;
             std::streamsize m_precision;
             std::streamsize m_required_precision = 0;
@@ -425,6 +525,7 @@ namespace xt
 
             cache_type m_cache;
             cache_iterator m_it;
+            std::vector<char> m_buffer;
         };
 
         template <class T>
@@ -446,10 +547,36 @@ namespace xt
 
             std::ostream& print_next(std::ostream& out)
             {
+                if (!m_stream_format_checked)
+                {
+                    m_stream_format = !has_default_number_format(out);
+                    m_stream_format_checked = true;
+                }
                 // + enables printing of chars etc. as numbers
                 // TODO should chars be printed as numbers?
-                out.width(m_width);
-                out << +(*m_it);
+                if (m_stream_format)
+                {
+                    out.width(m_width);
+                    out << +(*m_it);
+                    ++m_it;
+                    return out;
+                }
+                char buf[32];
+                char* last = detail::format_integer(buf, +(*m_it));
+                std::streamsize size = static_cast<std::streamsize>(last - buf);
+                bool left = (out.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+                if (left)
+                {
+                    out.write(buf, size);
+                }
+                for (std::streamsize i = size; i < m_width; ++i)
+                {
+                    out.put(out.fill());
+                }
+                if (!left)
+                {
+                    out.write(buf, size);
+                }
                 ++m_it;
                 return out;
             }
@@ -476,6 +603,8 @@ namespace xt
 
             std::streamsize m_width;
             bool m_sign = false;
+            bool m_stream_format = false;
+            bool m_stream_format_checked = false;
             value_type m_max = 0;
 
             cache_type m_cache;
@@ -763,7 +892,21 @@ namespace xt
         detail::recurser_run(p, d, sv, lim);
         p.init();
         sv.clear();
-        xoutput(out, d, sv, p, 1, p.width(), lim, static_cast<std::size_t>(po.line_width));
+        if (lim == 0 && out.rdbuf() != nullptr)
+        {
+            // Full print: gather the output in a large buffer
+            // instead of issuing small writes to the stream.
+            detail::xbuffered_streambuf buf(out.rdbuf());
+            std::ostream buffered_out(&buf);
+            buffered_out.copyfmt(out);
+            xoutput(buffered_out, d, sv, p, 1, p.width(), lim, static_cast<std::size_t>(po.line_width));
+            buffered_out.flush();
+            out.setstate(buffered_out.rdstate());
+        }
+        else
+        {
+            xoutput(out, d, sv, p, 1, p.width(), lim, static_cast<std::size_t>(po.line_width));
+        }
 
         out.precision(temp_precision);  // restore precision
 
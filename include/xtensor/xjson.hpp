@@ -10,15 +10,23 @@
 #ifndef XTENSOR_JSON_HPP
 #define XTENSOR_JSON_HPP
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "xstrided_view.hpp"
 #include "xtensor_config.hpp"
 
+#if NLOHMANN_JSON_VERSION_MAJOR > 3 || (NLOHMANN_JSON_VERSION_MAJOR == 3 && NLOHMANN_JSON_VERSION_MINOR >= 8)
+#define XTENSOR_JSON_HAS_BINARY
+#endif
+
 namespace xt
 {
     /*************************************
@@ -36,6 +44,22 @@ namespace xt
     enable_xview_semantics<E> from_json(const nlohmann::basic_json<M>&, E&);
     /// @endcond
 
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    void to_json_typed_array(nlohmann::basic_json<M>&, const xexpression<E>&);
+
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    enable_xcontainer_semantics<E> from_json_typed_array(const nlohmann::basic_json<M>&, E&);
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    enable_xview_semantics<E> from_json_typed_array(const nlohmann::basic_json<M>&, E&);
+    /// @endcond
+
+    template <template <typename U, typename V, typename... Args> class M>
+    bool is_json_typed_array(const nlohmann::basic_json<M>&);
+#endif
+
     /****************************************
      * to_json and from_json implementation *
      ****************************************/
@@ -117,6 +141,133 @@ namespace xt
                 }
             }
         }
+
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        /************************
+         * typed array encoding *
+         ************************/
+
+        // The typed array encoding stores the shape, the dtype and the
+        // row-major data as one binary value:
+        // {"dtype": "<f8", "shape": [2, 3], "data": <binary>}
+        // The dtype follows the NumPy array-protocol type strings.
+
+        template <class T>
+        struct json_typed_array_value
+            : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                           !std::is_same<T, long double>::value>
+        {
+        };
+
+        inline bool json_host_big_endian() noexcept
+        {
+            const std::uint16_t word = 1;
+            return *reinterpret_cast<const unsigned char*>(&word) == 0;
+        }
+
+        template <class T>
+        inline std::string json_dtype()
+        {
+            static_assert(json_typed_array_value<T>::value, "typed array encoding requires an arithmetic value type");
+            std::string res;
+            res += sizeof(T) == 1 ? '|' : (json_host_big_endian() ? '>' : '<');
+            res += std::is_same<T, bool>::value ? 'b' :
+                   std::is_floating_point<T>::value ? 'f' :
+                   std::is_signed<T>::value ? 'i' : 'u';
+            res += std::to_string(sizeof(T));
+            return res;
+        }
+
+        template <class T>
+        struct json_type_tag
+        {
+            using type = T;
+        };
+
+        /**
+         * Calls f with a json_type_tag of the C++ type matching dtype.
+         * Only dtypes in the host byte order are supported.
+         */
+        template <class F>
+        inline void dispatch_json_dtype(const std::string& dtype, F&& f)
+        {
+            if (dtype == json_dtype<bool>()) return f(json_type_tag<bool>());
+            if (dtype == json_dtype<std::int8_t>()) return f(json_type_tag<std::int8_t>());
+            if (dtype == json_dtype<std::uint8_t>()) return f(json_type_tag<std::uint8_t>());
+            if (dtype == json_dtype<std::int16_t>()) return f(json_type_tag<std::int16_t>());
+            if (dtype == json_dtype<std::uint16_t>()) return f(json_type_tag<std::uint16_t>());
+            if (dtype == json_dtype<std::int32_t>()) return f(json_type_tag<std::int32_t>());
+            if (dtype == json_dtype<std::uint32_t>()) return f(json_type_tag<std::uint32_t>());
+            if (dtype == json_dtype<std::int64_t>()) return f(json_type_tag<std::int64_t>());
+            if (dtype == json_dtype<std::uint64_t>()) return f(json_type_tag<std::uint64_t>());
+            if (dtype == json_dtype<float>()) return f(json_type_tag<float>());
+            if (dtype == json_dtype<double>()) return f(json_type_tag<double>());
+            XTENSOR_THROW(std::runtime_error, "Unsupported dtype in JSON typed array: " + dtype);
+        }
+
+        template <template <typename U, typename V, typename... Args> class M>
+        inline const typename nlohmann::basic_json<M>::binary_t& json_typed_array_data(const nlohmann::basic_json<M>& j)
+        {
+            const auto& data = j.at("data");
+            if (!data.is_binary())
+            {
+                XTENSOR_THROW(std::runtime_error, "JSON typed array data is not a binary value");
+            }
+            return data.get_binary();
+        }
+
+        template <class S, template <typename U, typename V, typename... Args> class M>
+        inline S json_typed_array_shape(const nlohmann::basic_json<M>& j)
+        {
+            const auto& js = j.at("shape");
+            S s = xtl::make_sequence<S>(js.size());
+            if (!js.is_array() || s.size() != js.size())
+            {
+                XTENSOR_THROW(std::runtime_error, "Dimension mismatch when deserializing JSON typed array");
+            }
+            std::transform(js.cbegin(), js.cend(), s.begin(), [](const auto& d) {
+                return d.template get<typename S::value_type>();
+            });
+            return s;
+        }
+
+        template <template <typename U, typename V, typename... Args> class M, class D>
+        inline void from_json_typed_array_data(const nlohmann::basic_json<M>& j, D& e)
+        {
+            using value_type = typename D::value_type;
+            const auto& bytes = json_typed_array_data(j);
+            std::size_t size = compute_size(e.shape());
+            dispatch_json_dtype(j.at("dtype").template get<std::string>(), [&](auto tag) {
+                using source_type = typename decltype(tag)::type;
+                if (bytes.size() != size * sizeof(source_type))
+                {
+                    XTENSOR_THROW(std::runtime_error, "JSON typed array data size does not match its shape");
+                }
+                // The binary container is allocated with operator new,
+                // hence suitably aligned for any arithmetic type.
+                const source_type* first = reinterpret_cast<const source_type*>(bytes.data());
+                std::transform(first, first + size, e.template begin<layout_type::row_major>(),
+                               [](const source_type& v) { return static_cast<value_type>(v); });
+            });
+        }
+
+        template <template <typename U, typename V, typename... Args> class M, class E>
+        inline bool try_from_json_typed_array(const nlohmann::basic_json<M>& j, E& e, std::true_type /*arithmetic*/)
+        {
+            if (is_json_typed_array(j))
+            {
+                from_json_typed_array(j, e);
+                return true;
+            }
+            return false;
+        }
+
+        template <template <typename U, typename V, typename... Args> class M, class E>
+        inline bool try_from_json_typed_array(const nlohmann::basic_json<M>&, E&, std::false_type /*arithmetic*/)
+        {
+            return false;
+        }
+#endif
     }
 
     /**
@@ -149,12 +300,20 @@ namespace xt
      * case for expressions with a view semantics. In this case, from_json can
      * be called directly.
      *
+     * Objects written by \ref to_json_typed_array are also accepted.
+     *
      * @param j a const JSON object
      * @param e an \ref xexpression
      */
     template <template <typename U, typename V, typename... Args> class M, class E>
     inline enable_xcontainer_semantics<E> from_json(const nlohmann::basic_json<M>& j, E& e)
     {
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        if (detail::try_from_json_typed_array(j, e, std::is_arithmetic<typename E::value_type>()))
+        {
+            return;
+        }
+#endif
         auto dimension = detail::json_dimension(j);
         auto s = xtl::make_sequence<typename E::shape_type>(dimension);
         detail::json_shape(j, s);
@@ -170,6 +329,12 @@ namespace xt
     template <template <typename U, typename V, typename... Args> class M, class E>
     inline enable_xview_semantics<E> from_json(const nlohmann::basic_json<M>& j, E& e)
     {
+#if defined(XTENSOR_JSON_HAS_BINARY)
+        if (detail::try_from_json_typed_array(j, e, std::is_arithmetic<typename E::value_type>()))
+        {
+            return;
+        }
+#endif
         typename E::shape_type s;
         detail::json_shape(j, s);
 
@@ -183,6 +348,84 @@ namespace xt
         detail::from_json_impl(j, e, sv);
     }
     /// @endcond
+
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    /**
+     * @brief Typed array JSON serialization of an xtensor expression.
+     *
+     * Instead of nested arrays, the expression is stored as an object holding
+     * its shape, its dtype (NumPy type string) and its elements in row-major
+     * order as a single binary value. The binary value is natively supported
+     * by the CBOR, MessagePack and BSON encodings of nlohmann_json, avoiding
+     * the creation of one JSON node per element.
+     *
+     * @param j a JSON object
+     * @param e a const \ref xexpression with an arithmetic value type
+     */
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    inline void to_json_typed_array(nlohmann::basic_json<M>& j, const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        using json_type = nlohmann::basic_json<M>;
+        using binary_container = typename json_type::binary_t::container_type;
+
+        const E& de = e.derived_cast();
+        std::size_t size = compute_size(de.shape());
+        binary_container bytes(size * sizeof(value_type));
+        std::copy(de.template cbegin<layout_type::row_major>(), de.template cend<layout_type::row_major>(),
+                  reinterpret_cast<value_type*>(bytes.data()));
+
+        j = json_type::object();
+        j["dtype"] = detail::json_dtype<value_type>();
+        j["shape"] = json_type::array();
+        for (auto d : de.shape())
+        {
+            j["shape"].push_back(static_cast<std::size_t>(d));
+        }
+        j["data"] = json_type::binary(std::move(bytes));
+    }
+
+    /**
+     * @brief Typed array JSON deserialization of an xtensor expression with
+     * a container semantics.
+     *
+     * Reads an object written by \ref to_json_typed_array. The elements
+     * are converted to the value type of the expression if the dtype differs.
+     *
+     * @param j a const JSON object
+     * @param e an \ref xexpression
+     */
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    inline enable_xcontainer_semantics<E> from_json_typed_array(const nlohmann::basic_json<M>& j, E& e)
+    {
+        e.resize(detail::json_typed_array_shape<typename E::shape_type>(j));
+        detail::from_json_typed_array_data(j, e);
+    }
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <template <typename U, typename V, typename... Args> class M, class E>
+    inline enable_xview_semantics<E> from_json_typed_array(const nlohmann::basic_json<M>& j, E& e)
+    {
+        auto s = detail::json_typed_array_shape<std::vector<std::size_t>>(j);
+        if (s.size() != e.dimension() || !std::equal(s.cbegin(), s.cend(), e.shape().cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "Shape mismatch when deserializing JSON to view");
+        }
+        detail::from_json_typed_array_data(j, e);
+    }
+    /// @endcond
+
+    /**
+     * @brief Returns true if the JSON value holds an expression
+     * serialized with \ref to_json_typed_array.
+     */
+    template <template <typename U, typename V, typename... Args> class M>
+    inline bool is_json_typed_array(const nlohmann::basic_json<M>& j)
+    {
+        return j.is_object() && j.find("dtype") != j.end() &&
+               j.find("shape") != j.end() && j.find("data") != j.end();
+    }
+#endif
 }
 
 #endif
@@ -2088,14 +2088,231 @@ namespace detail {
         {
             return make_xshared(std::move(e));
         }
+
+        /*******************
+         * welford kernels *
+         *******************/
+
+        // Count, mean and sum of squared differences from the mean of a
+        // set of values, updated with Welford's algorithm. Partial states
+        // are merged with the formulas of Chan et al.
+        template <class T>
+        struct welford_state
+        {
+            T count;
+            T mean;
+            T m2;
+        };
+
+        template <class T>
+        struct welford_reduce
+        {
+            template <class V>
+            welford_state<T> operator()(welford_state<T> s, const V& v) const
+            {
+                T x = static_cast<T>(v);
+                s.count += T(1);
+                T delta = x - s.mean;
+                s.mean += delta / s.count;
+                s.m2 += delta * (x - s.mean);
+                return s;
+            }
+        };
+
+        template <class T>
+        struct welford_merge
+        {
+            welford_state<T> operator()(const welford_state<T>& a, const welford_state<T>& b) const
+            {
+                if (b.count == T(0))
+                {
+                    return a;
+                }
+                if (a.count == T(0))
+                {
+                    return b;
+                }
+                T count = a.count + b.count;
+                T delta = b.mean - a.mean;
+                return welford_state<T>{count,
+                                        a.mean + delta * b.count / count,
+                                        a.m2 + b.m2 + delta * delta * a.count * b.count / count};
+            }
+        };
+
+        template <class T>
+        struct welford_variance
+        {
+            T ddof;
+
+            T operator()(const welford_state<T>& s) const
+            {
+                return s.m2 / (s.count - ddof);
+            }
+        };
+
+        // Same as welford_state, with the sums of the third and fourth
+        // powers of the differences from the mean (Pebay's formulas).
+        template <class T>
+        struct moments_state
+        {
+            T count;
+            T mean;
+            T m2;
+            T m3;
+            T m4;
+        };
+
+        template <class T>
+        struct moments_reduce
+        {
+            template <class V>
+            moments_state<T> operator()(moments_state<T> s, const V& v) const
+            {
+                T x = static_cast<T>(v);
+                T n1 = s.count;
+                s.count += T(1);
+                T n = s.count;
+                T delta = x - s.mean;
+                T delta_n = delta / n;
+                T delta_n2 = delta_n * delta_n;
+                T term = delta * delta_n * n1;
+                s.mean += delta_n;
+                s.m4 += term * delta_n2 * (n * n - T(3) * n + T(3)) + T(6) * delta_n2 * s.m2 - T(4) * delta_n * s.m3;
+                s.m3 += term * delta_n * (n - T(2)) - T(3) * delta_n * s.m2;
+                s.m2 += term;
+                return s;
+            }
+        };
+
+        template <class T>
+        struct moments_merge
+        {
+            moments_state<T> operator()(const moments_state<T>& a, const moments_state<T>& b) const
+            {
+                if (b.count == T(0))
+                {
+                    return a;
+                }
+                if (a.count == T(0))
+                {
+                    return b;
+                }
+                T na = a.count;
+                T nb = b.count;
+                T n = na + nb;
+                T delta = b.mean - a.mean;
+                T delta2 = delta * delta;
+                moments_state<T> r;
+                r.count = n;
+                r.mean = a.mean + delta * nb / n;
+                r.m2 = a.m2 + b.m2 + delta2 * na * nb / n;
+                r.m3 = a.m3 + b.m3 + delta2 * delta * na * nb * (na - nb) / (n * n)
+                     + T(3) * delta * (na * b.m2 - nb * a.m2) / n;
+                r.m4 = a.m4 + b.m4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+                     + T(6) * delta2 * (na * na * b.m2 + nb * nb * a.m2) / (n * n)
+                     + T(4) * delta * (na * b.m3 - nb * a.m3) / n;
+                return r;
+            }
+        };
+
+        template <class T>
+        struct moments_result
+        {
+            std::array<T, 4> operator()(const moments_state<T>& s) const
+            {
+                T var = s.m2 / s.count;
+                T skew = std::sqrt(s.count) * s.m3 / std::pow(s.m2, T(1.5));
+                T kurt = s.count * s.m4 / (s.m2 * s.m2) - T(3);
+                return std::array<T, 4>{{s.mean, var, skew, kurt}};
+            }
+        };
+
+        // The single pass algorithm is used for real values, when the
+        // result is a floating point number.
+        template <class T, class E>
+        using use_welford = std::integral_constant<bool,
+            std::is_arithmetic<typename std::decay_t<E>::value_type>::value &&
+            (std::is_same<T, void>::value || std::is_floating_point<T>::value)>;
+
+        template <class T>
+        using welford_result_t = std::conditional_t<std::is_same<T, void>::value, double, T>;
+
+        template <class T>
+        inline auto welford_functors()
+        {
+            using state_type = welford_state<T>;
+            return make_xreducer_functor(welford_reduce<T>(), const_value<state_type>(state_type{}), welford_merge<T>());
+        }
+
+        // An immediate single pass reduction is evaluated into a container,
+        // like the other immediate reducers; a lazy one stays an expression.
+        template <class E>
+        inline auto welford_finalize(E&& e, evaluation_strategy::lazy_type)
+        {
+            return std::forward<E>(e);
+        }
+
+        template <class E>
+        inline auto welford_finalize(E&& e, evaluation_strategy::immediate_type)
+        {
+            return xt::eval(std::forward<E>(e));
+        }
+
+        template <class T, class EVS>
+        using welford_strategy_t = typename reducer_options<T, std::decay_t<EVS>>::evaluation_strategy;
+
+        template <class T, class E, class D, class EVS>
+        inline auto variance_noaxis(E&& e, const D& ddof, EVS es, std::true_type)
+        {
+            using result_type = welford_result_t<T>;
+            auto red = xt::reduce(welford_functors<result_type>(), std::forward<E>(e), es);
+            return welford_finalize(make_lambda_xfunction(welford_variance<result_type>{static_cast<result_type>(ddof)}, std::move(red)),
+                                    welford_strategy_t<result_type, EVS>());
+        }
+
+        template <class T, class E, class D, class EVS>
+        inline auto variance_noaxis(E&& e, const D& ddof, EVS es, std::false_type)
+        {
+            auto cached_mean = mean<T>(e, es)();
+            return detail::mean_noaxis<T>(square(std::forward<E>(e) - std::move(cached_mean)), ddof, es);
+        }
+
+        template <class T, class E, class X, class D, class EVS>
+        inline auto variance(E&& e, X&& axes, const D& ddof, EVS es, std::true_type)
+        {
+            using result_type = welford_result_t<T>;
+            auto red = xt::reduce(welford_functors<result_type>(), std::forward<E>(e), std::forward<X>(axes), es);
+            return welford_finalize(make_lambda_xfunction(welford_variance<result_type>{static_cast<result_type>(ddof)}, std::move(red)),
+                                    welford_strategy_t<result_type, EVS>());
+        }
+
+        template <class T, class E, class X, class D, class EVS>
+        inline auto variance(E&& e, X&& axes, const D& ddof, EVS es, std::false_type)
+        {
+            decltype(auto) sc = detail::shared_forward<E>(e);
+            // note: forcing copy of first axes argument -- is there a better solution?
+            auto axes_copy = axes;
+            // always eval to prevent repeated evaluations in the next calls
+            auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), evaluation_strategy::immediate));
+
+            // fake keep_dims = 1
+            auto keep_dim_shape = e.shape();
+            for (const auto& el : axes)
+            {
+                keep_dim_shape[el] = 1u;
+            }
+
+            auto mrv = reshape_view<XTENSOR_DEFAULT_LAYOUT>(std::move(inner_mean), std::move(keep_dim_shape));
+            return detail::mean<T>(square(sc - std::move(mrv)), std::forward<X>(axes), ddof, es);
+        }
     }
 
     template <class T = void, class E, class D, class EVS = DEFAULT_STRATEGY_REDUCERS,
               XTL_REQUIRES(is_reducer_options<EVS>, std::is_integral<D>)>
     inline auto variance(E&& e, D const& ddof, EVS es = EVS())
     {
-        auto cached_mean = mean<T>(e, es)();
-        return detail::mean_noaxis<T>(square(std::forward<E>(e) - std::move(cached_mean)), ddof, es);
+        return detail::variance_noaxis<T>(std::forward<E>(e), ddof, es, detail::use_welford<T, E>());
     }
 
     template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2121,6 +2338,9 @@ namespace detail {
      * distribution. The variance is computed for the flattened array by default,
      * otherwise over the specified axes.
      *
+     * For real values, the variance is computed in a single pass with Welford's
+     * algorithm, which is numerically stable.
+     *
      * Note: this function is not yet specialized for complex numbers.
      *
      * @param e an \ref xexpression
@@ -2137,21 +2357,7 @@ namespace detail {
               XTL_REQUIRES(xtl::negation<is_reducer_options<X>>, std::is_integral<D>)>
     inline auto variance(E&& e, X&& axes, const D& ddof, EVS es = EVS())
     {
-        decltype(auto) sc = detail::shared_forward<E>(e);
-        // note: forcing copy of first axes argument -- is there a better solution?
-        auto axes_copy = axes;
-        // always eval to prevent repeated evaluations in the next calls
-        auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), evaluation_strategy::immediate));
-
-        // fake keep_dims = 1
-        auto keep_dim_shape = e.shape();
-        for (const auto& el : axes)
-        {
-            keep_dim_shape[el] = 1u;
-        }
-
-        auto mrv = reshape_view<XTENSOR_DEFAULT_LAYOUT>(std::move(inner_mean), std::move(keep_dim_shape));
-        return detail::mean<T>(square(sc - std::move(mrv)), std::forward<X>(axes), ddof, es);
+        return detail::variance<T>(std::forward<E>(e), std::forward<X>(axes), ddof, es, detail::use_welford<T, E>());
     }
 
     template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2240,6 +2446,66 @@ namespace detail {
     }
 #endif
 
+    /**
+     * @ingroup red_functions
+     * @brief Compute the first four moments along the specified axes.
+     *
+     * Returns the mean, the variance, the skewness and the excess kurtosis of
+     * the array elements, computed in a single pass. The moments are computed
+     * for the flattened array by default, otherwise over the specified axes.
+     * The variance is the biased one (ddof = 0), and the skewness and kurtosis
+     * are the biased estimators g1 and g2.
+     *
+     * @param e an \ref xexpression of real values
+     * @param axes the axes along which the moments are computed (optional)
+     * @param es evaluation strategy to use (lazy (default), or immediate)
+     * @return an \ref xexpression of type ``std::array<T, 4>`` (``std::array<double, 4>``
+     *         if \em T is void), holding the mean, variance, skewness and kurtosis
+     *
+     * @sa variance, mean
+     */
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
+    inline auto moments(E&& e, X&& axes, EVS es = EVS())
+    {
+        using result_type = detail::welford_result_t<T>;
+        using state_type = detail::moments_state<result_type>;
+        static_assert(std::is_floating_point<result_type>::value, "moments requires a floating point result type");
+        static_assert(std::is_arithmetic<typename std::decay_t<E>::value_type>::value, "moments requires real values");
+        auto red = xt::reduce(make_xreducer_functor(detail::moments_reduce<result_type>(),
+                                                    const_value<state_type>(state_type{}),
+                                                    detail::moments_merge<result_type>()),
+                              std::forward<E>(e), std::forward<X>(axes), es);
+        return detail::welford_finalize(make_lambda_xfunction(detail::moments_result<result_type>(), std::move(red)),
+                                        detail::welford_strategy_t<result_type, EVS>());
+    }
+
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto moments(E&& e, EVS es = EVS())
+    {
+        auto axes = arange(e.dimension());
+        return moments<T>(std::forward<E>(e), std::move(axes), es);
+    }
+
+#ifndef X_OLD_CLANG
+    template <class T = void, class E, class A, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, const A (&axes)[N], EVS es = EVS())
+    {
+        return moments<T>(std::forward<E>(e),
+                          xtl::forward_sequence<std::array<std::size_t, N>, decltype(axes)>(axes),
+                          es);
+    }
+#else
+    template <class T = void, class E, class A, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, std::initializer_list<A> axes, EVS es = EVS())
+    {
+        return moments<T>(std::forward<E>(e),
+                          xtl::forward_sequence<dynamic_shape<std::size_t>, decltype(axes)>(axes),
+                          es);
+    }
+#endif
+
     /**
      * @ingroup red_functions
      * @brief Minimum and maximum among the elements of an array or expression.
@@ -2370,6 +2636,13 @@ namespace detail {
             {
                 return !math::isnan(rhs) ? lhs + rhs : lhs;
             }
+
+            template <class B>
+            auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                // rhs != rhs is true for nan only
+                return xt_simd::select(rhs != rhs, lhs, lhs + rhs);
+            }
         };
 
         template <class T>
@@ -2382,6 +2655,13 @@ namespace detail {
             {
                 return !math::isnan(rhs) ? lhs * rhs : lhs;
             }
+
+            template <class B>
+            auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                // rhs != rhs is true for nan only
+                return xt_simd::select(rhs != rhs, lhs, lhs * rhs);
+            }
         };
 
         template <class T, int V>
@@ -2750,6 +3030,9 @@ namespace detail {
      * distribution. The variance is computed for the flattened array by default,
      * otherwise over the specified axes.
      *
+     * For real values, the variance is computed in a single pass with Welford's
+     * algorithm, which is numerically stable.
+     *
      * Note: this function is not yet specialized for complex numbers.
      *
      * @param e an \ref xexpression
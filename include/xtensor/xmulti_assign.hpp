@@ -0,0 +1,286 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_MULTI_ASSIGN_HPP
+#define XTENSOR_MULTI_ASSIGN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xassign.hpp"
+#include "xexception.hpp"
+#include "xiterator.hpp"
+#include "xutils.hpp"
+
+// Number of elements assigned to each destination before moving to the next one
+#ifndef XTENSOR_MULTI_ASSIGN_BLOCK_SIZE
+#define XTENSOR_MULTI_ASSIGN_BLOCK_SIZE 1024
+#endif
+
+namespace xt
+{
+
+    /****************
+     * multi_assign *
+     ****************/
+
+    template <class... D, class... E>
+    void multi_assign(std::tuple<D&...> destinations, const xexpression<E>&... expressions);
+
+    /*******************************
+     * multi_assign implementation *
+     *******************************/
+
+    namespace detail
+    {
+        template <class D, class E>
+        inline auto multi_assign_shape(const E& e, bool& trivial_broadcast)
+        {
+            using index_type = xindex_type_t<typename D::shape_type>;
+            index_type shape = uninitialized_shape<index_type>(e.dimension());
+            trivial_broadcast = e.broadcast_shape(shape, true);
+            return shape;
+        }
+
+        template <bool simd>
+        struct multi_linear_assigner
+        {
+            template <class E1, class E2>
+            static void run(E1& e1, const E2& e2, std::size_t first, std::size_t last)
+            {
+                using e1_value_type = typename E1::value_type;
+                using e2_value_type = typename E2::value_type;
+                using value_type = typename xassign_traits<E1, E2>::requested_value_type;
+                using simd_type = xt_simd::simd_type<value_type>;
+                constexpr std::size_t simd_size = simd_type::size;
+                constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
+
+                std::size_t simd_end = first + ((last - first) & ~(simd_size - 1));
+                std::size_t i = first;
+                for (; i < simd_end; i += simd_size)
+                {
+                    e1.template store_simd<unaligned_mode>(i, e2.template load_simd<unaligned_mode, value_type>(i));
+                }
+                for (; i < last; ++i)
+                {
+                    e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
+                }
+            }
+        };
+
+        template <>
+        struct multi_linear_assigner<false>
+        {
+            template <class E1, class E2>
+            static void run(E1& e1, const E2& e2, std::size_t first, std::size_t last)
+            {
+                using e1_value_type = typename E1::value_type;
+                using e2_value_type = typename E2::value_type;
+                constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
+                }
+            }
+        };
+
+        template <class E1, class E2>
+        inline void multi_linear_assign(E1& e1, const E2& e2, bool use_simd, std::size_t first, std::size_t last)
+        {
+            constexpr bool simd_assign = xassign_traits<E1, E2>::simd_assign();
+            if (simd_assign && use_simd)
+            {
+                multi_linear_assigner<simd_assign>::run(e1, e2, first, last);
+            }
+            else
+            {
+                multi_linear_assigner<false>::run(e1, e2, first, last);
+            }
+        }
+
+        template <class E1, class E2>
+        class multi_stepper_pair
+        {
+        public:
+
+            using lhs_stepper = typename E1::stepper;
+            using rhs_stepper = typename E2::const_stepper;
+            using size_type = typename lhs_stepper::size_type;
+
+            template <class S>
+            multi_stepper_pair(E1& e1, const E2& e2, const S& shape)
+                : m_lhs(e1.stepper_begin(shape)), m_rhs(e2.stepper_begin(shape))
+            {
+            }
+
+            void assign()
+            {
+                using argument_type = std::decay_t<decltype(*m_rhs)>;
+                using result_type = std::decay_t<decltype(*m_lhs)>;
+                constexpr bool needs_cast = has_assign_conversion<argument_type, result_type>::value;
+                *m_lhs = conditional_cast<needs_cast, result_type>(*m_rhs);
+            }
+
+            void step(size_type i)
+            {
+                m_lhs.step(i);
+                m_rhs.step(i);
+            }
+
+            void reset(size_type i)
+            {
+                m_lhs.reset(i);
+                m_rhs.reset(i);
+            }
+
+            void to_end(layout_type l)
+            {
+                m_lhs.to_end(l);
+                m_rhs.to_end(l);
+            }
+
+        private:
+
+            lhs_stepper m_lhs;
+            rhs_stepper m_rhs;
+        };
+
+        // Steps all the (destination, expression) pairs in lockstep, so that
+        // stepper_tools visits each index once for all of them.
+        template <class... P>
+        class multi_stepper
+        {
+        public:
+
+            using size_type = std::size_t;
+
+            explicit multi_stepper(P&&... pairs)
+                : m_pairs(std::move(pairs)...)
+            {
+            }
+
+            void assign()
+            {
+                xt::for_each([](auto& p) { p.assign(); }, m_pairs);
+            }
+
+            void step(size_type i)
+            {
+                xt::for_each([i](auto& p) { p.step(i); }, m_pairs);
+            }
+
+            void reset(size_type i)
+            {
+                xt::for_each([i](auto& p) { p.reset(i); }, m_pairs);
+            }
+
+            void to_end(layout_type l)
+            {
+                xt::for_each([l](auto& p) { p.to_end(l); }, m_pairs);
+            }
+
+        private:
+
+            std::tuple<P...> m_pairs;
+        };
+
+        template <class... D, class... E, std::size_t... I>
+        inline void multi_assign_impl(std::tuple<D&...>& d, const std::tuple<const E&...>& e,
+                                      std::index_sequence<I...>)
+        {
+            using first_type = std::decay_t<std::tuple_element_t<0, std::tuple<D...>>>;
+            constexpr std::size_t nb_pairs = sizeof...(D);
+
+            // The shapes are checked before any destination is resized, so
+            // that the destinations are left untouched when the check throws.
+            std::array<bool, nb_pairs> trivial;
+            auto shapes = std::make_tuple(multi_assign_shape<D>(std::get<I>(e), trivial[I])...);
+            const auto& first_shape = std::get<0>(shapes);
+            std::array<bool, nb_pairs> same = {{xt::same_shape(first_shape, std::get<I>(shapes))...}};
+            if (!std::all_of(same.cbegin(), same.cend(), [](bool b) { return b; }))
+            {
+                XTENSOR_THROW(std::runtime_error, "multi_assign: all the expressions must have the same shape");
+            }
+            (void)std::initializer_list<int>{(std::get<I>(d).resize(std::move(std::get<I>(shapes))), 0)...};
+
+            const auto& first = std::get<0>(d);
+
+            std::array<bool, nb_pairs> linear = {{xassign_traits<D, E>::linear_assign(std::get<I>(d), std::get<I>(e), trivial[I])...}};
+            if (std::all_of(linear.cbegin(), linear.cend(), [](bool b) { return b; }))
+            {
+                std::array<bool, nb_pairs> use_simd = {{(xassign_traits<D, E>::simd_linear_assign() ||
+                                                         xassign_traits<D, E>::simd_linear_assign(std::get<I>(d), std::get<I>(e)))...}};
+                std::size_t size = first.size();
+                for (std::size_t block = 0; block < size; block += XTENSOR_MULTI_ASSIGN_BLOCK_SIZE)
+                {
+                    // Each block of the inputs is still in cache when it is
+                    // read for the next destination.
+                    std::size_t last = std::min(block + XTENSOR_MULTI_ASSIGN_BLOCK_SIZE, size);
+                    (void)std::initializer_list<int>{(multi_linear_assign(std::get<I>(d), std::get<I>(e), use_simd[I], block, last), 0)...};
+                }
+            }
+            else
+            {
+                using index_type = xindex_type_t<typename first_type::shape_type>;
+                constexpr layout_type L = default_assignable_layout(first_type::static_layout);
+                const auto& shape = first.shape();
+                multi_stepper<multi_stepper_pair<D, E>...> stepper(multi_stepper_pair<D, E>(std::get<I>(d), std::get<I>(e), shape)...);
+                index_type index = xtl::make_sequence<index_type>(shape.size(), std::size_t(0));
+                std::size_t size = first.size();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    stepper.assign();
+                    stepper_tools<L>::increment_stepper(stepper, index, shape);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Assigns several expressions in a single traversal.
+     *
+     * Evaluates each expression into the corresponding destination, like
+     * noalias(std::get<I>(destinations)) = expressions, but visits the
+     * elements once for all the pairs instead of once per pair: when the
+     * expressions share their inputs, these inputs are read from memory
+     * once instead of once per destination.
+     *
+     * If all the pairs can be assigned linearly, the assignment proceeds by
+     * blocks of XTENSOR_MULTI_ASSIGN_BLOCK_SIZE elements, each block being
+     * assigned to all the destinations (with SIMD instructions when possible)
+     * before moving to the next one. Otherwise, the steppers of all the pairs
+     * are incremented together.
+     *
+     * \code{.cpp}
+     * xt::xtensor<double, 1> mn, mx, s;
+     * xt::multi_assign(std::tie(mn, mx, s), xt::amin(x, {1}), xt::amax(x, {1}), xt::sum(x, {1}));
+     * \endcode
+     *
+     * @param destinations tuple of references to the destinations.
+     * @param expressions the expressions to assign, they must have the same shape.
+     * @warning Like noalias, no temporary is used: the destinations must
+     * not be involved in the expressions.
+     */
+    template <class... D, class... E>
+    inline void multi_assign(std::tuple<D&...> destinations, const xexpression<E>&... expressions)
+    {
+        static_assert(sizeof...(D) == sizeof...(E), "multi_assign requires one expression per destination");
+        static_assert(sizeof...(D) != 0, "multi_assign requires at least one destination");
+        std::tuple<const E&...> exprs(expressions.derived_cast()...);
+        detail::multi_assign_impl(destinations, exprs, std::make_index_sequence<sizeof...(D)>());
+    }
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <complex>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -469,6 +470,114 @@ namespace xt
             return header;
         }
 
+        /*********************
+         * dtype conversions *
+         *********************/
+
+        template <class T>
+        struct npy_is_complex : std::false_type
+        {
+        };
+
+        template <class T>
+        struct npy_is_complex<std::complex<T>> : std::true_type
+        {
+        };
+
+        // Values are converted to arithmetic or complex types only,
+        // and complex values can only be converted to complex values
+        template <class S, class T>
+        using npy_convertible = std::integral_constant<bool, (std::is_arithmetic<T>::value && !npy_is_complex<S>::value) ||
+                                                             npy_is_complex<T>::value>;
+
+        template <class T>
+        struct npy_type_tag
+        {
+            using type = T;
+        };
+
+        /**
+         * Calls f with a npy_type_tag of the C++ type matching the kind and
+         * the size of a typestring. Returns false if the kind or the size
+         * is not supported.
+         */
+        template <class F>
+        inline bool dispatch_typestring(char kind, std::size_t size, F&& f)
+        {
+            switch (kind)
+            {
+                case 'b':
+                    if (size == 1) { f(npy_type_tag<bool>()); return true; }
+                    break;
+                case 'i':
+                    if (size == 1) { f(npy_type_tag<std::int8_t>()); return true; }
+                    if (size == 2) { f(npy_type_tag<std::int16_t>()); return true; }
+                    if (size == 4) { f(npy_type_tag<std::int32_t>()); return true; }
+                    if (size == 8) { f(npy_type_tag<std::int64_t>()); return true; }
+                    break;
+                case 'u':
+                    if (size == 1) { f(npy_type_tag<std::uint8_t>()); return true; }
+                    if (size == 2) { f(npy_type_tag<std::uint16_t>()); return true; }
+                    if (size == 4) { f(npy_type_tag<std::uint32_t>()); return true; }
+                    if (size == 8) { f(npy_type_tag<std::uint64_t>()); return true; }
+                    break;
+                case 'f':
+                    if (size == sizeof(float)) { f(npy_type_tag<float>()); return true; }
+                    if (size == sizeof(double)) { f(npy_type_tag<double>()); return true; }
+                    break;
+                case 'c':
+                    if (size == sizeof(std::complex<float>)) { f(npy_type_tag<std::complex<float>>()); return true; }
+                    if (size == sizeof(std::complex<double>)) { f(npy_type_tag<std::complex<double>>()); return true; }
+                    break;
+                default:
+                    break;
+            }
+            return false;
+        }
+
+        template <class S>
+        inline S load_npy_value(const char* src, bool swap_bytes) noexcept
+        {
+            S res;
+            char* dst = reinterpret_cast<char*>(&res);
+            if (swap_bytes)
+            {
+                // Complex values are swapped component-wise
+                constexpr std::size_t n = npy_is_complex<S>::value ? 2 : 1;
+                constexpr std::size_t word = sizeof(S) / n;
+                for (std::size_t c = 0; c != n; ++c)
+                {
+                    for (std::size_t b = 0; b != word; ++b)
+                    {
+                        dst[c * word + b] = src[c * word + word - 1 - b];
+                    }
+                }
+            }
+            else
+            {
+                std::memcpy(dst, src, sizeof(S));
+            }
+            return res;
+        }
+
+        template <class S, class T>
+        inline void convert_npy_buffer(const char* src, char* dst, std::size_t size, bool swap_bytes, std::true_type)
+        {
+            // Element i is read before being overwritten, therefore the
+            // conversion can run in place when src == dst and sizeof(S) == sizeof(T).
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                T value = static_cast<T>(load_npy_value<S>(src + i * sizeof(S), swap_bytes));
+                std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+            }
+        }
+
+        template <class S, class T>
+        inline void convert_npy_buffer(const char*, char*, std::size_t, bool, std::false_type)
+        {
+            XTENSOR_THROW(std::runtime_error, "Cast error: values of the npy file cannot be converted to the requested type");
+        }
+
         struct npy_file
         {
             npy_file() = default;
@@ -533,12 +642,12 @@ namespace xt
                 std::vector<std::size_t> strides(m_shape.size());
                 std::size_t sz = compute_size(m_shape);
 
-                // check if the typestring matches the given one
+                // check if the typestring matches the given one,
+                // convert the buffer otherwise
                 if (check_type && m_typestring != detail::build_typestring<T>())
                 {
-                    XTENSOR_THROW(std::runtime_error,
-                                  "Cast error: formats not matching "s + m_typestring +
-                                  " vs "s + detail::build_typestring<T>());
+                    convert<T>();
+                    ptr = reinterpret_cast<T*>(&m_buffer[0]);
                 }
 
                 if ((L == layout_type::column_major && !m_fortran_order) ||
@@ -580,6 +689,56 @@ namespace xt
                              no_ownership(), std::get<2>(cast_elems), std::get<3>(cast_elems));
             }
 
+            /**
+             * Converts the buffer to the value type T, in the host byte order.
+             * The conversion is done in a single pass, in place when the size
+             * of T matches the size of the stored type.
+             */
+            template <class T>
+            void convert()
+            {
+                std::string target = detail::build_typestring<T>();
+                if (m_typestring == target)
+                {
+                    return;
+                }
+
+                char endianness = m_typestring[0];
+                char kind = m_typestring[1];
+                bool swap_bytes = endianness != no_endian_char && endianness != host_endian_char;
+                std::size_t size = compute_size(m_shape);
+
+                bool supported = dispatch_typestring(kind, m_word_size, [&](auto tag) {
+                    using source_type = typename decltype(tag)::type;
+                    using convertible = npy_convertible<source_type, T>;
+                    // An unsupported conversion throws before
+                    // the converted buffer is allocated
+                    if (sizeof(source_type) == sizeof(T) || !convertible::value)
+                    {
+                        convert_npy_buffer<source_type, T>(m_buffer, m_buffer, size, swap_bytes, convertible());
+                    }
+                    else
+                    {
+                        std::size_t n_bytes = size * sizeof(T);
+                        char* buffer = std::allocator<char>{}.allocate(n_bytes);
+                        convert_npy_buffer<source_type, T>(m_buffer, buffer, size, swap_bytes, convertible());
+                        std::allocator<char>{}.deallocate(m_buffer, m_n_bytes);
+                        m_buffer = buffer;
+                        m_n_bytes = n_bytes;
+                    }
+                });
+
+                if (!supported)
+                {
+                    XTENSOR_THROW(std::runtime_error,
+                                  "Cast error: formats not matching "s + m_typestring +
+                                  " vs "s + target);
+                }
+
+                m_word_size = sizeof(T);
+                m_typestring = target;
+            }
+
             char* ptr()
             {
                 return m_buffer;
@@ -691,8 +850,9 @@ namespace xt
      * Loads a npy file (the numpy storage format)
      *
      * @param stream An input stream from which to load the file
-     * @tparam T select the type of the npy file (note: currently there is
-     *           no dynamic casting if types do not match)
+     * @tparam T select the value type of the returned array; if the npy file
+     *           holds another numeric type or byte order, the values are converted
+     *           in a single pass (in place when the sizes of both types match)
      * @tparam L select layout_type::column_major if you stored data in
      *           Fortran format
      * @return xarray with contents from npy file
@@ -708,8 +868,9 @@ namespace xt
      * Loads a npy file (the numpy storage format)
      *
      * @param filename The filename or path to the file
-     * @tparam T select the type of the npy file (note: currently there is
-     *           no dynamic casting if types do not match)
+     * @tparam T select the value type of the returned array; if the npy file
+     *           holds another numeric type or byte order, the values are converted
+     *           in a single pass (in place when the sizes of both types match)
      * @tparam L select layout_type::column_major if you stored data in
      *           Fortran format
      * @return xarray with contents from npy file
@@ -0,0 +1,379 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PADDED_HPP
+#define XTENSOR_PADDED_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <xtl/xsequence.hpp>
+
+#include "xcontainer.hpp"
+#include "xsemantic.hpp"
+
+namespace xt
+{
+
+    /******************************
+     * xtensor_padded declaration *
+     ******************************/
+
+    template <class EC, std::size_t N, class Tag>
+    struct xcontainer_inner_types<xtensor_padded_container<EC, N, Tag>>
+    {
+        using storage_type = EC;
+        using reference = inner_reference_t<storage_type>;
+        using const_reference = typename storage_type::const_reference;
+        using size_type = typename storage_type::size_type;
+        using shape_type = std::array<typename storage_type::size_type, N>;
+        using strides_type = get_strides_t<shape_type>;
+        using backstrides_type = get_strides_t<shape_type>;
+        using inner_shape_type = shape_type;
+        using inner_strides_type = strides_type;
+        using inner_backstrides_type = backstrides_type;
+        using temporary_type = xtensor_padded_container<EC, N, Tag>;
+        // The elements are not contiguous in memory, the layout of
+        // the rows is held at runtime (always row_major).
+        static constexpr layout_type layout = layout_type::dynamic;
+    };
+
+    template <class EC, std::size_t N, class Tag>
+    struct xiterable_inner_types<xtensor_padded_container<EC, N, Tag>>
+        : xcontainer_iterable_types<xtensor_padded_container<EC, N, Tag>>
+    {
+    };
+
+    /**
+     * @class xtensor_padded_container
+     * @brief Dense row-major container with fixed dimension and padded rows.
+     *
+     * The xtensor_padded_container class implements a row-major container
+     * whose rows (the sequences of elements along the last dimension) are
+     * padded so that each of them starts on a XTENSOR_DEFAULT_ALIGNMENT
+     * bytes boundary. The stride of the second to last dimension, called
+     * the pitch, is the width of the rows rounded up to the number of
+     * elements fitting in this alignment.
+     *
+     * The strided assignment loop processes such containers row by row,
+     * and computes the end of the rows with full SIMD batches instead of
+     * scalar operations when all the operands of the assigned expression
+     * are scalars or padded containers with the same shape. The values of
+     * the padding elements are unspecified after such an assignment.
+     *
+     * Since the elements are not contiguous, the container cannot be
+     * reshaped nor grown with push_back or append.
+     *
+     * @tparam EC The type of the container holding the elements.
+     * @tparam N The dimension of the container.
+     * @tparam Tag The expression tag.
+     * @sa xtensor_padded, xstrided_container, xcontainer
+     */
+    template <class EC, std::size_t N, class Tag>
+    class xtensor_padded_container : public xstrided_container<xtensor_padded_container<EC, N, Tag>>,
+                                     public xcontainer_semantic<xtensor_padded_container<EC, N, Tag>>
+    {
+    public:
+
+        using self_type = xtensor_padded_container<EC, N, Tag>;
+        using base_type = xstrided_container<self_type>;
+        using semantic_base = xcontainer_semantic<self_type>;
+        using storage_type = typename base_type::storage_type;
+        using allocator_type = typename base_type::allocator_type;
+        using value_type = typename base_type::value_type;
+        using reference = typename base_type::reference;
+        using const_reference = typename base_type::const_reference;
+        using pointer = typename base_type::pointer;
+        using const_pointer = typename base_type::const_pointer;
+        using size_type = typename base_type::size_type;
+        using shape_type = typename base_type::shape_type;
+        using inner_shape_type = typename base_type::inner_shape_type;
+        using strides_type = typename base_type::strides_type;
+        using backstrides_type = typename base_type::backstrides_type;
+        using inner_backstrides_type = typename base_type::inner_backstrides_type;
+        using inner_strides_type = typename base_type::inner_strides_type;
+        using temporary_type = typename semantic_base::temporary_type;
+        using expression_tag = Tag;
+        constexpr static std::size_t rank = N;
+
+        xtensor_padded_container();
+        xtensor_padded_container(nested_initializer_list_t<value_type, N> t);
+        explicit xtensor_padded_container(const shape_type& shape);
+        explicit xtensor_padded_container(const shape_type& shape, const_reference value);
+
+        template <class S = shape_type>
+        static xtensor_padded_container from_shape(S&& s);
+
+        ~xtensor_padded_container() = default;
+
+        xtensor_padded_container(const xtensor_padded_container&) = default;
+        xtensor_padded_container& operator=(const xtensor_padded_container&) = default;
+
+        xtensor_padded_container(xtensor_padded_container&&) = default;
+        xtensor_padded_container& operator=(xtensor_padded_container&&) = default;
+
+        template <class E>
+        xtensor_padded_container(const xexpression<E>& e);
+
+        template <class E>
+        xtensor_padded_container& operator=(const xexpression<E>& e);
+
+        template <class S = shape_type>
+        void resize(S&& shape, bool force = false);
+
+        template <class S = shape_type>
+        void resize(S&& shape, layout_type l) = delete;
+        template <class S = shape_type>
+        void resize(S&& shape, const strides_type& strides) = delete;
+
+        template <class S = shape_type>
+        auto& reshape(S&& shape, layout_type layout = base_type::static_layout) & = delete;
+
+        void push_back(const value_type& value) = delete;
+
+        template <class E>
+        void append(const xexpression<E>& e) = delete;
+
+        size_type pitch() const noexcept;
+        size_type padding() const noexcept;
+        bool is_contiguous() const noexcept;
+
+        template <class S>
+        bool has_linear_assign(const S& strides) const noexcept;
+
+    private:
+
+        storage_type m_storage;
+
+        storage_type& storage_impl() noexcept;
+        const storage_type& storage_impl() const noexcept;
+
+        friend class xcontainer<xtensor_padded_container<EC, N, Tag>>;
+    };
+
+    /*******************************************
+     * xtensor_padded_container implementation *
+     *******************************************/
+
+    namespace detail
+    {
+        template <class T>
+        inline std::size_t padded_pitch(std::size_t width) noexcept
+        {
+            constexpr std::size_t alignment = XTENSOR_DEFAULT_ALIGNMENT;
+            // No padding if the rows cannot be aligned
+            constexpr std::size_t batch = (alignment != 0 && alignment % sizeof(T) == 0) ? alignment / sizeof(T) : 1;
+            return (width + batch - 1) / batch * batch;
+        }
+
+        template <class T, class S, class ST, class BST>
+        inline std::size_t compute_padded_strides(const S& shape, ST& strides, BST& backstrides)
+        {
+            using strides_value_type = typename ST::value_type;
+            std::size_t dim = shape.size();
+            if (dim == 0)
+            {
+                return std::size_t(1);
+            }
+            strides_value_type data_size = static_cast<strides_value_type>(padded_pitch<T>(shape[dim - 1]));
+            strides[dim - 1] = strides_value_type(1);
+            for (std::size_t i = dim - 1; i != 0; --i)
+            {
+                strides[i - 1] = data_size;
+                data_size = strides[i - 1] * static_cast<strides_value_type>(shape[i - 1]);
+            }
+            for (std::size_t i = 0; i != dim; ++i)
+            {
+                adapt_strides(shape, strides, &backstrides, i);
+            }
+            return static_cast<std::size_t>(data_size);
+        }
+    }
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Allocates an uninitialized xtensor_padded_container that holds 0 elements.
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline xtensor_padded_container<EC, N, Tag>::xtensor_padded_container()
+        : base_type(), m_storage(N == 0 ? 1 : 0, value_type())
+    {
+        this->mutable_layout() = layout_type::row_major;
+    }
+
+    /**
+     * Allocates an xtensor_padded_container with nested initializer lists.
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline xtensor_padded_container<EC, N, Tag>::xtensor_padded_container(nested_initializer_list_t<value_type, N> t)
+        : base_type()
+    {
+        resize(xt::shape<shape_type>(t), true);
+        nested_copy(this->template begin<layout_type::row_major>(), t);
+    }
+
+    /**
+     * Allocates an uninitialized xtensor_padded_container with the specified shape.
+     * @param shape the shape of the xtensor_padded_container
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline xtensor_padded_container<EC, N, Tag>::xtensor_padded_container(const shape_type& shape)
+        : base_type()
+    {
+        resize(shape, true);
+    }
+
+    /**
+     * Allocates an xtensor_padded_container with the specified shape. Elements
+     * are initialized to the specified value.
+     * @param shape the shape of the xtensor_padded_container
+     * @param value the value of the elements
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline xtensor_padded_container<EC, N, Tag>::xtensor_padded_container(const shape_type& shape, const_reference value)
+        : base_type()
+    {
+        resize(shape, true);
+        std::fill(m_storage.begin(), m_storage.end(), value);
+    }
+
+    /**
+     * Allocates and returns an xtensor_padded_container with the specified shape.
+     * @param s the shape of the xtensor_padded_container
+     */
+    template <class EC, std::size_t N, class Tag>
+    template <class S>
+    inline xtensor_padded_container<EC, N, Tag> xtensor_padded_container<EC, N, Tag>::from_shape(S&& s)
+    {
+        XTENSOR_ASSERT_MSG(s.size() == N, "Cannot change dimension of xtensor.");
+        shape_type shape = xtl::forward_sequence<shape_type, S>(s);
+        return self_type(shape);
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended copy constructor.
+     */
+    template <class EC, std::size_t N, class Tag>
+    template <class E>
+    inline xtensor_padded_container<EC, N, Tag>::xtensor_padded_container(const xexpression<E>& e)
+        : base_type()
+    {
+        XTENSOR_ASSERT_MSG(N == e.derived_cast().dimension(), "Cannot change dimension of xtensor.");
+        this->mutable_layout() = layout_type::row_major;
+        if (e.derived_cast().dimension() == 0)
+        {
+            detail::resize_data_container(m_storage, std::size_t(1));
+        }
+        semantic_base::assign(e);
+    }
+
+    /**
+     * The extended assignment operator.
+     */
+    template <class EC, std::size_t N, class Tag>
+    template <class E>
+    inline auto xtensor_padded_container<EC, N, Tag>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    /**
+     * Resizes the container. The rows are padded so that each of them
+     * starts on an aligned address.
+     * @warning Contrary to STL containers like std::vector, resize
+     * does NOT preserve the container elements.
+     * @param shape the new shape
+     * @param force force reshaping, even if the shape stays the same (default: false)
+     */
+    template <class EC, std::size_t N, class Tag>
+    template <class S>
+    inline void xtensor_padded_container<EC, N, Tag>::resize(S&& shape, bool force)
+    {
+        XTENSOR_ASSERT_MSG(shape.size() == N, "Cannot change dimension of xtensor.");
+        auto& sh = this->shape_impl();
+        if (!std::equal(std::begin(shape), std::end(shape), std::begin(sh)) || force)
+        {
+            sh = xtl::forward_sequence<shape_type, S>(shape);
+            this->mutable_layout() = layout_type::row_major;
+            std::size_t data_size = detail::compute_padded_strides<value_type>(sh, this->strides_impl(), this->backstrides_impl());
+            detail::resize_data_container(m_storage, data_size);
+            if (padding() != 0)
+            {
+                // Padding elements are read by full SIMD batches
+                std::fill(m_storage.begin(), m_storage.end(), value_type());
+            }
+        }
+    }
+
+    /**
+     * Returns the number of elements between the beginnings of two
+     * consecutive rows.
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline auto xtensor_padded_container<EC, N, Tag>::pitch() const noexcept -> size_type
+    {
+        return N == 0 ? size_type(1) : static_cast<size_type>(detail::padded_pitch<value_type>(this->shape()[N - 1]));
+    }
+
+    /**
+     * Returns the number of padding elements at the end of each row.
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline auto xtensor_padded_container<EC, N, Tag>::padding() const noexcept -> size_type
+    {
+        return N == 0 ? size_type(0) : pitch() - this->shape()[N - 1];
+    }
+
+    /**
+     * Returns true if the rows are not padded.
+     */
+    template <class EC, std::size_t N, class Tag>
+    inline bool xtensor_padded_container<EC, N, Tag>::is_contiguous() const noexcept
+    {
+        return padding() == 0;
+    }
+
+    /**
+     * Checks whether the xtensor_padded_container can be linearly assigned
+     * to an expression with the specified strides, which is only the case
+     * if its rows are not padded.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class EC, std::size_t N, class Tag>
+    template <class S>
+    inline bool xtensor_padded_container<EC, N, Tag>::has_linear_assign(const S& strides) const noexcept
+    {
+        return padding() == 0 && base_type::has_linear_assign(strides);
+    }
+
+    template <class EC, std::size_t N, class Tag>
+    inline auto xtensor_padded_container<EC, N, Tag>::storage_impl() noexcept -> storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class EC, std::size_t N, class Tag>
+    inline auto xtensor_padded_container<EC, N, Tag>::storage_impl() const noexcept -> const storage_type&
+    {
+        return m_storage;
+    }
+}
+
+#endif
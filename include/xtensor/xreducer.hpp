@@ -11,9 +11,13 @@
 #define XTENSOR_REDUCER_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
@@ -26,14 +30,21 @@
 #include <xtl/xsequence.hpp>
 
 #include "xaccessible.hpp"
+#include "xassign.hpp"
 #include "xbuilder.hpp"
 #include "xeval.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
+// Number of independent SIMD accumulators used by the reduction kernels
+#ifndef XTENSOR_REDUCE_ACCUMULATORS
+#define XTENSOR_REDUCE_ACCUMULATORS 4
+#endif
+
 namespace xt
 {
     template <template <class...> class A, class... AX, class X,
@@ -263,6 +274,154 @@ namespace xt
         }
     }
 
+    /*********************
+     * reduction kernels *
+     *********************/
+
+    namespace detail
+    {
+        template <class F, class T, class = void>
+        struct simd_reduce_functor : std::false_type
+        {
+        };
+
+        template <class F, class T>
+        struct simd_reduce_functor<F, T, void_t<decltype(std::declval<const F&>().simd_apply(std::declval<const xt_simd::simd_type<T>&>(),
+                                                                                               std::declval<const xt_simd::simd_type<T>&>()))>>
+            : std::true_type
+        {
+            template <class B>
+            static B apply(const F& f, const B& lhs, const B& rhs)
+            {
+                return f.simd_apply(lhs, rhs);
+            }
+        };
+
+        template <class U, class T>
+        struct simd_reduce_functor<std::plus<U>, T, void> : std::true_type
+        {
+            template <class B>
+            static B apply(const std::plus<U>&, const B& lhs, const B& rhs)
+            {
+                return lhs + rhs;
+            }
+        };
+
+        template <class U, class T>
+        struct simd_reduce_functor<std::multiplies<U>, T, void> : std::true_type
+        {
+            template <class B>
+            static B apply(const std::multiplies<U>&, const B& lhs, const B& rhs)
+            {
+                return lhs * rhs;
+            }
+        };
+
+        // The SIMD kernels change the order in which the elements are reduced,
+        // they are used for arithmetic types only, when the elements do not
+        // need to be converted to the result type.
+        template <class F, class R, class V>
+        struct use_simd_reduce
+            : xtl::conjunction<std::is_same<R, V>,
+                               std::is_arithmetic<R>,
+                               xtl::negation<std::is_same<R, bool>>,
+                               has_simd_type<R>,
+                               simd_reduce_functor<F, R>>
+        {
+        };
+
+        template <bool simd>
+        struct reduce_kernel
+        {
+            // Reduces the n contiguous elements starting at first. Several
+            // accumulators are used so that successive SIMD operations do not
+            // depend on each other.
+            template <class F, class T>
+            static T accumulate(const F& f, T init, const T* first, std::size_t n)
+            {
+                using batch_type = xt_simd::simd_type<T>;
+                using functor_type = simd_reduce_functor<F, T>;
+                constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+                constexpr std::size_t nb_acc = XTENSOR_REDUCE_ACCUMULATORS;
+                constexpr std::size_t block_size = nb_acc * simd_size;
+
+                std::size_t i = 0;
+                if (n >= block_size)
+                {
+                    std::array<batch_type, nb_acc> acc;
+                    for (std::size_t k = 0; k < nb_acc; ++k)
+                    {
+                        acc[k] = xt_simd::load_simd<T, T>(first + k * simd_size, unaligned_mode());
+                    }
+                    for (i = block_size; i + block_size <= n; i += block_size)
+                    {
+                        for (std::size_t k = 0; k < nb_acc; ++k)
+                        {
+                            acc[k] = functor_type::apply(f, acc[k], xt_simd::load_simd<T, T>(first + i + k * simd_size, unaligned_mode()));
+                        }
+                    }
+                    for (; i + simd_size <= n; i += simd_size)
+                    {
+                        acc[0] = functor_type::apply(f, acc[0], xt_simd::load_simd<T, T>(first + i, unaligned_mode()));
+                    }
+                    for (std::size_t k = 1; k < nb_acc; ++k)
+                    {
+                        acc[0] = functor_type::apply(f, acc[0], acc[k]);
+                    }
+                    std::array<T, simd_size> buffer;
+                    xt_simd::store_simd(buffer.data(), acc[0], unaligned_mode());
+                    for (std::size_t k = 0; k < simd_size; ++k)
+                    {
+                        init = f(init, buffer[k]);
+                    }
+                }
+                for (; i < n; ++i)
+                {
+                    init = f(init, first[i]);
+                }
+                return init;
+            }
+
+            // Reduces the row into out, elementwise.
+            template <class F, class T>
+            static void rows(const F& f, T* out, const T* row, std::size_t n)
+            {
+                using functor_type = simd_reduce_functor<F, T>;
+                constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+
+                std::size_t i = 0;
+                for (; i + simd_size <= n; i += simd_size)
+                {
+                    xt_simd::store_simd(out + i,
+                                        functor_type::apply(f,
+                                                            xt_simd::load_simd<T, T>(out + i, unaligned_mode()),
+                                                            xt_simd::load_simd<T, T>(row + i, unaligned_mode())),
+                                        unaligned_mode());
+                }
+                for (; i < n; ++i)
+                {
+                    out[i] = f(out[i], row[i]);
+                }
+            }
+        };
+
+        template <>
+        struct reduce_kernel<false>
+        {
+            template <class F, class R, class V>
+            static R accumulate(F& f, R init, const V* first, std::size_t n)
+            {
+                return std::accumulate(first, first + n, init, f);
+            }
+
+            template <class F, class R, class V>
+            static void rows(F& f, R* out, const V* row, std::size_t n)
+            {
+                std::transform(out, out + n, row, out, f);
+            }
+        };
+    }
+
     template <class F, class E, class X, class O>
     inline auto reduce_immediate(F&& f, E&& e, X&& axes, O&& raw_options)
     {
@@ -270,6 +429,7 @@ namespace xt
         using init_functor_type = typename std::decay_t<F>::init_functor_type;
         using expr_value_type = typename std::decay_t<E>::value_type;
         using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(std::declval<init_functor_type>()(), std::declval<expr_value_type>()))>;
+        using kernel_type = detail::reduce_kernel<detail::use_simd_reduce<reduce_functor_type, result_type, expr_value_type>::value>;
 
         using options_t = reducer_options<result_type, std::decay_t<O>>;
         options_t options(raw_options);
@@ -316,7 +476,7 @@ namespace xt
         if (e.dimension() == axes.size())
         {
             result_type tmp = options_t::has_initial_value ? options.initial_value : init_fct();
-            result.data()[0] = std::accumulate(e.storage().begin(), e.storage().end(), tmp, reduce_fct);
+            result.data()[0] = kernel_type::accumulate(reduce_fct, tmp, e.data(), e.storage().size());
             return result;
         }
 
@@ -436,10 +596,10 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                // for unknown reasons it's much faster to use a temporary variable and
-                // std::accumulate here -- probably some cache behavior
+                // for unknown reasons it's much faster to use a temporary variable
+                // here -- probably some cache behavior
                 result_type tmp = init_fct();
-                tmp = std::accumulate(begin , begin + outer_loop_size, tmp, reduce_fct);
+                tmp = kernel_type::accumulate(reduce_fct, tmp, begin, outer_loop_size);
 
                 // use merge function if necessary
                 *out = merge ? merge_fct(*out, tmp) : tmp;
@@ -466,18 +626,16 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        reduce_fct(static_cast<result_type>(init_fct()), v2);
-                               });
-
-                begin += inner_stride;
-                for (std::size_t i = 1; i < outer_loop_size; ++i)
+                if (!merge)
+                {
+                    // cast because return type of identity function is not upcasted
+                    std::fill(out, out + inner_loop_size, static_cast<result_type>(init_fct()));
+                }
+
+                // The rows are reduced into the result vector
+                for (std::size_t i = 0; i < outer_loop_size; ++i)
                 {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
+                    kernel_type::rows(reduce_fct, out, begin, inner_loop_size);
                     begin += inner_stride;
                 }
 
@@ -792,12 +950,29 @@ namespace xt
         }
 
 
+        // reduce_immediate reads the storage of the evaluated expression as a
+        // dense array, so a padded container is copied into a dense one first.
+        template <class E>
+        inline decltype(auto) reduce_immediate_eval(E&& e, std::false_type)
+        {
+            return eval(std::forward<E>(e));
+        }
+
+        template <class E>
+        inline auto reduce_immediate_eval(E&& e, std::true_type)
+        {
+            using expression_type = std::decay_t<E>;
+            using dense_type = xtensor<typename expression_type::value_type,
+                                       std::tuple_size<typename expression_type::shape_type>::value>;
+            return dense_type(std::forward<E>(e));
+        }
+
         template <class F, class E, class X, class O>
         inline auto reduce_impl(F&& f, E&& e, X&& axes, evaluation_strategy::immediate_type, O&& options)
         {
             decltype(auto) normalized_axes = normalize_axis(e, std::forward<X>(axes));
             return reduce_immediate(std::forward<F>(f),
-                                    eval(std::forward<E>(e)),
+                                    reduce_immediate_eval(std::forward<E>(e), is_padded_container<std::decay_t<E>>()),
                                     std::forward<decltype(normalized_axes)>(normalized_axes),
                                     std::forward<O>(options)
             );
@@ -958,10 +1133,21 @@ namespace xt
 
     private:
 
+        // The SIMD kernel can reduce an axis of the expression if its
+        // elements are contiguous in memory.
+        using contiguous_reduce = xtl::conjunction<has_data_interface<xexpression_type>,
+                                                   has_strides<xexpression_type>,
+                                                   std::is_lvalue_reference<decltype(*std::declval<const substepper_type&>())>,
+                                                   detail::use_simd_reduce<typename xreducer_type::reduce_functor_type,
+                                                                           value_type,
+                                                                           typename xexpression_type::value_type>>;
+
         reference initial_value() const;
         reference aggregate(size_type dim) const;
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::false_type) const;
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::true_type) const;
+        reference aggregate_axis(size_type index, size_type size, /*contiguous=*/ std::false_type) const;
+        reference aggregate_axis(size_type index, size_type size, /*contiguous=*/ std::true_type) const;
 
         substepper_type get_substepper_begin() const;
         size_type get_dim(size_type dim) const noexcept;
@@ -1555,12 +1741,7 @@ namespace xt
         }
         else
         {
-            res = static_cast<reference>(m_reducer->m_init());
-            for (size_type i = 0; i != size; ++i, m_stepper.step(index))
-            {
-                res = m_reducer->m_reduce(res, *m_stepper);
-            }
-            m_stepper.step_back(index);
+            res = aggregate_axis(index, size, contiguous_reduce());
         }
         m_stepper.reset(index);
         return res;
@@ -1587,12 +1768,7 @@ namespace xt
             }
             else
             {
-                res = m_reducer->m_init();
-                for (size_type i = 0; i != size; ++i, m_stepper.step(index))
-                {
-                    res = m_reducer->m_reduce(res, *m_stepper);
-                }
-                m_stepper.step_back(index);
+                res = aggregate_axis(index, size, contiguous_reduce());
             }
             m_stepper.reset(index);
         }
@@ -1607,6 +1783,34 @@ namespace xt
     }
 
 
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::aggregate_axis(size_type index, size_type size, std::false_type) const -> reference
+    {
+        reference res = static_cast<reference>(m_reducer->m_init());
+        for (size_type i = 0; i != size; ++i, m_stepper.step(index))
+        {
+            res = m_reducer->m_reduce(res, *m_stepper);
+        }
+        m_stepper.step_back(index);
+        return res;
+    }
+
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::aggregate_axis(size_type index, size_type size, std::true_type) const -> reference
+    {
+        if (size > 1 && m_reducer->m_e.strides()[index] == 1)
+        {
+            reference res = detail::reduce_kernel<true>::accumulate(m_reducer->m_reduce,
+                                                                    static_cast<reference>(m_reducer->m_init()),
+                                                                    std::addressof(*m_stepper),
+                                                                    size);
+            // Leaves the stepper on the last element of the axis, as the scalar loop does
+            m_stepper.step(index, size - 1);
+            return res;
+        }
+        return aggregate_axis(index, size, std::false_type());
+    }
+
     template <class F, class CT, class X, class O>
     inline auto xreducer_stepper<F, CT, X, O>::get_substepper_begin() const -> substepper_type
     {
@@ -10,7 +10,9 @@
 #ifndef XTENSOR_SEMANTIC_HPP
 #define XTENSOR_SEMANTIC_HPP
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <utility>
 
 #include "xassign.hpp"
@@ -152,6 +154,14 @@ namespace xt
 
         template <class E>
         derived_type& operator=(const xexpression<E>&);
+
+    private:
+
+        template <class E>
+        derived_type& assign_maybe_aliased(const xexpression<E>&, std::true_type);
+
+        template <class E>
+        derived_type& assign_maybe_aliased(const xexpression<E>&, std::false_type);
     };
 
     template <class E>
@@ -272,6 +282,233 @@ namespace xt
     template <class E, class R = void>
     using disable_xview_semantics = typename std::enable_if<!has_view_semantics<E>::value, R>::type;
 
+    /******************
+     * alias analysis *
+     ******************/
+
+    template <class CT, class X>
+    class xbroadcast;
+
+    namespace detail
+    {
+        // Containers whose elements are stored in a contiguous buffer
+        template <class E, bool B = xtl::conjunction<is_crtp_base_of<xcontainer, E>, is_xtensor_expression<E>>::value>
+        struct is_alias_checkable : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_alias_checkable<E, true> : has_data_interface<typename E::storage_type>
+        {
+        };
+
+        // A temporary is always used for dynamic layout destinations, since
+        // assigning it may change their layout.
+        template <class D, bool B = xtl::conjunction<is_alias_checkable<D>, has_container_semantics<D>>::value>
+        struct is_alias_checkable_destination : std::false_type
+        {
+        };
+
+        template <class D>
+        struct is_alias_checkable_destination<D, true>
+            : std::integral_constant<bool, D::static_layout != layout_type::dynamic>
+        {
+        };
+
+        template <class E, class = void>
+        struct has_expression_accessor : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_expression_accessor<E, void_t<decltype(std::declval<const E&>().expression())>>
+            : std::true_type
+        {
+        };
+
+        // Memory written by an assignment. Reading the destination itself is
+        // harmless when it is read elementwise, that is at the position being
+        // written, and when it is not resized by the assignment.
+        struct alias_target
+        {
+            const void* object;
+            std::uintptr_t first;
+            std::uintptr_t last;
+            bool same_shape;
+
+            bool overlaps(std::uintptr_t f, std::uintptr_t l) const noexcept
+            {
+                return f < last && first < l;
+            }
+        };
+
+        template <class E>
+        bool may_alias(const alias_target& target, const E& e, bool elementwise);
+
+        template <class F, class... CT>
+        bool may_alias(const alias_target& target, const xfunction<F, CT...>& e, bool elementwise);
+
+        template <class CT>
+        bool may_alias(const alias_target& target, const xscalar<CT>& e, bool elementwise);
+
+        template <class CT, class X>
+        bool may_alias(const alias_target& target, const xbroadcast<CT, X>& e, bool elementwise);
+
+        template <class E>
+        inline bool may_alias_view(const alias_target& target, const E& e, std::true_type)
+        {
+            // Views do not read their underlying expression elementwise
+            return may_alias(target, e.expression(), false);
+        }
+
+        template <class E>
+        inline bool may_alias_view(const alias_target&, const E&, std::false_type)
+        {
+            // Unknown expressions, such as generators, may refer to anything
+            return true;
+        }
+
+        template <class E>
+        inline bool may_alias_leaf(const alias_target& target, const E& e, bool elementwise, std::true_type)
+        {
+            std::uintptr_t first = reinterpret_cast<std::uintptr_t>(e.data());
+            std::uintptr_t last = reinterpret_cast<std::uintptr_t>(e.data() + e.storage().size());
+            if (!target.overlaps(first, last))
+            {
+                return false;
+            }
+            return !(elementwise && target.same_shape && static_cast<const void*>(&e) == target.object);
+        }
+
+        template <class E>
+        inline bool may_alias_leaf(const alias_target& target, const E& e, bool, std::false_type)
+        {
+            return may_alias_view(target, e, has_expression_accessor<E>());
+        }
+
+        template <class E>
+        inline bool may_alias(const alias_target& target, const E& e, bool elementwise)
+        {
+            return may_alias_leaf(target, e, elementwise, std::integral_constant<bool, is_alias_checkable<E>::value>());
+        }
+
+        template <class F, class... CT>
+        inline bool may_alias(const alias_target& target, const xfunction<F, CT...>& e, bool elementwise)
+        {
+            // Functors with a state, such as vectorized lambdas with captures,
+            // may refer to the destination
+            if (!std::is_empty<F>::value)
+            {
+                return true;
+            }
+            auto func = [&target, elementwise](bool res, const auto& arg) {
+                return res || may_alias(target, arg, elementwise);
+            };
+            return xt::accumulate(func, false, e.arguments());
+        }
+
+        template <class CT>
+        inline bool may_alias(const alias_target& target, const xscalar<CT>& e, bool)
+        {
+            // The scalar may hold a reference to an element of the destination
+            std::uintptr_t first = reinterpret_cast<std::uintptr_t>(std::addressof(e()));
+            return target.overlaps(first, first + sizeof(typename xscalar<CT>::value_type));
+        }
+
+        template <class CT, class X>
+        inline bool may_alias(const alias_target& target, const xbroadcast<CT, X>& e, bool elementwise)
+        {
+            return may_alias(target, e.expression(), elementwise);
+        }
+
+        /**
+         * Returns false if evaluating \c e never reads the memory written
+         * by its assignment to \c dest, in which case \c e can be assigned
+         * to \c dest without a temporary.
+         */
+        template <class D, class E>
+        inline bool may_alias_destination(const D& dest, const E& e)
+        {
+            std::uintptr_t first = reinterpret_cast<std::uintptr_t>(dest.data());
+            alias_target target = {
+                static_cast<const void*>(&dest),
+                first,
+                reinterpret_cast<std::uintptr_t>(dest.data() + dest.storage().size()),
+                dest.dimension() == e.dimension() &&
+                    std::equal(dest.shape().cbegin(), dest.shape().cend(), e.shape().cbegin())
+            };
+            return may_alias(target, e, true);
+        }
+    }
+
+    /************************
+     * operand buffer reuse *
+     ************************/
+
+    namespace detail
+    {
+        // An operand can give its buffer to the result of the function
+        // if the function owns it (rvalue closure) and if it has the
+        // type of the result container.
+        template <class D, class CT>
+        using is_reusable_operand = xtl::conjunction<xtl::negation<std::is_reference<CT>>,
+                                                     std::is_same<CT, D>>;
+
+        template <class D, class F, class A>
+        inline bool reuse_operand(D&, const F&, A&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class D, class F, class A>
+        inline bool reuse_operand(D& dest, const F& f, A& arg, std::true_type)
+        {
+            if (arg.dimension() != f.dimension() ||
+                !std::equal(arg.shape().cbegin(), arg.shape().cend(), f.shape().cbegin()))
+            {
+                return false;
+            }
+            // The operand is only read elementwise at the position being
+            // written; the other operands, such as a scalar closure holding
+            // a reference to one of its elements, must not refer to it.
+            if (may_alias_destination(arg, f))
+            {
+                return false;
+            }
+            xt::assign_xexpression(arg, f);
+            dest = std::move(arg);
+            return true;
+        }
+
+        template <std::size_t I, class D, class F, class... CT>
+        inline std::enable_if_t<I == sizeof...(CT), bool>
+        reuse_operand_buffer_impl(D&, xfunction<F, CT...>&)
+        {
+            return false;
+        }
+
+        template <std::size_t I, class D, class F, class... CT>
+        inline std::enable_if_t<(I < sizeof...(CT)), bool>
+        reuse_operand_buffer_impl(D& dest, xfunction<F, CT...>& f)
+        {
+            using operand_type = std::tuple_element_t<I, std::tuple<CT...>>;
+            return reuse_operand(dest, f, std::get<I>(f.arguments()), is_reusable_operand<D, operand_type>()) ||
+                   reuse_operand_buffer_impl<I + 1>(dest, f);
+        }
+
+        /**
+         * Evaluates \c f in the buffer of one of its rvalue operands and
+         * moves the result into \c dest, if an operand has the type of
+         * \c dest and the shape of \c f. Returns false if no operand can
+         * be reused, in which case \c dest is left unchanged.
+         */
+        template <class D, class F, class... CT>
+        inline bool reuse_operand_buffer(D& dest, xfunction<F, CT...>& f)
+        {
+            return reuse_operand_buffer_impl<0>(dest, f);
+        }
+    }
+
     /*********************************
      * xsemantic_base implementation *
      *********************************/
@@ -596,6 +833,25 @@ namespace xt
     template <class D>
     template <class E>
     inline auto xsemantic_base<D>::operator=(const xexpression<E>& e) -> derived_type&
+    {
+        return assign_maybe_aliased(e, std::integral_constant<bool, detail::is_alias_checkable_destination<D>::value>());
+    }
+
+    template <class D>
+    template <class E>
+    inline auto xsemantic_base<D>::assign_maybe_aliased(const xexpression<E>& e, std::true_type) -> derived_type&
+    {
+        // The temporary is only required if e reads the memory being written
+        if (!detail::may_alias_destination(this->derived_cast(), e.derived_cast()))
+        {
+            return this->derived_cast().assign_xexpression(e);
+        }
+        return assign_maybe_aliased(e, std::false_type());
+    }
+
+    template <class D>
+    template <class E>
+    inline auto xsemantic_base<D>::assign_maybe_aliased(const xexpression<E>& e, std::false_type) -> derived_type&
     {
         temporary_type tmp(e);
         return this->derived_cast().assign_temporary(std::move(tmp));
@@ -11,6 +11,7 @@
 #define XTENSOR_STORAGE_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <initializer_list>
@@ -118,6 +119,9 @@ namespace xt
         const_reverse_iterator crbegin() const noexcept;
         const_reverse_iterator crend() const noexcept;
 
+        void push_back(const_reference value);
+        void push_back(value_type&& value);
+
         void swap(uvector& rhs) noexcept;
 
     private:
@@ -126,6 +130,8 @@ namespace xt
         void init_data(I first, I last);
 
         void resize_impl(size_type new_size);
+        void reallocate_impl(size_type new_cap);
+        void grow(size_type min_capacity);
 
         allocator_type m_allocator;
 
@@ -133,6 +139,7 @@ namespace xt
         // storing a pointer to the beginning and the size of the container
         pointer p_begin;
         pointer p_end;
+        pointer p_capacity;
     };
 
     template <class T, class A>
@@ -182,7 +189,8 @@ namespace xt
 
         template <class A>
         inline void safe_destroy_deallocate(A& alloc, typename std::allocator_traits<A>::pointer ptr,
-                                            typename std::allocator_traits<A>::size_type size)
+                                            typename std::allocator_traits<A>::size_type size,
+                                            typename std::allocator_traits<A>::size_type capacity)
         {
             using traits = std::allocator_traits<A>;
             using pointer = typename traits::pointer;
@@ -196,9 +204,63 @@ namespace xt
                         traits::destroy(alloc, p);
                     }
                 }
-                traits::deallocate(alloc, ptr, size);
+                traits::deallocate(alloc, ptr, capacity);
             }
         }
+
+        template <class A>
+        inline void safe_destroy_deallocate(A& alloc, typename std::allocator_traits<A>::pointer ptr,
+                                            typename std::allocator_traits<A>::size_type size)
+        {
+            safe_destroy_deallocate(alloc, ptr, size, size);
+        }
+
+        template <class A, class = void>
+        struct has_reallocate : std::false_type
+        {
+        };
+
+        template <class A>
+        struct has_reallocate<A, void_t<decltype(std::declval<A&>().reallocate(std::declval<typename std::allocator_traits<A>::pointer>(),
+                                                                                std::declval<typename std::allocator_traits<A>::size_type>(),
+                                                                                std::declval<typename std::allocator_traits<A>::size_type>()))>>
+            : std::true_type
+        {
+        };
+
+        // Moves the size first elements of ptr to a buffer of capacity new_cap.
+        // Allocators providing a reallocate method (such as huge_page_allocator)
+        // may extend the buffer without copying it when the elements are trivial.
+        template <class A>
+        inline typename std::allocator_traits<A>::pointer
+        reallocate_buffer(A& alloc, typename std::allocator_traits<A>::pointer ptr,
+                   typename std::allocator_traits<A>::size_type size,
+                   typename std::allocator_traits<A>::size_type old_cap,
+                   typename std::allocator_traits<A>::size_type new_cap,
+                   std::true_type /*use_reallocate*/)
+        {
+            (void)size;
+            return ptr != nullptr ? alloc.reallocate(ptr, old_cap, new_cap) : alloc.allocate(new_cap);
+        }
+
+        template <class A>
+        inline typename std::allocator_traits<A>::pointer
+        reallocate_buffer(A& alloc, typename std::allocator_traits<A>::pointer ptr,
+                   typename std::allocator_traits<A>::size_type size,
+                   typename std::allocator_traits<A>::size_type old_cap,
+                   typename std::allocator_traits<A>::size_type new_cap,
+                   std::false_type /*use_reallocate*/)
+        {
+            using traits = std::allocator_traits<A>;
+            using pointer = typename traits::pointer;
+            pointer res = alloc.allocate(new_cap);
+            if (ptr != nullptr)
+            {
+                std::uninitialized_copy(std::make_move_iterator(ptr), std::make_move_iterator(ptr + size), res);
+                safe_destroy_deallocate(alloc, ptr, size, old_cap);
+            }
+            return res;
+        }
     }
 
     template <class T, class A>
@@ -211,6 +273,7 @@ namespace xt
             p_begin = m_allocator.allocate(size);
             std::uninitialized_copy(first, last, p_begin);
             p_end = p_begin + size;
+            p_capacity = p_end;
         }
     }
 
@@ -218,13 +281,57 @@ namespace xt
     inline void uvector<T, A>::resize_impl(size_type new_size)
     {
         size_type old_size = size();
-        pointer old_begin = p_begin;
-        if (new_size != old_size)
+        if (new_size > old_size && new_size <= capacity())
         {
+            // Growing within the reserved storage preserves the elements
+            pointer new_end = p_begin + new_size;
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                for (pointer p = p_end; p != new_end; ++p)
+                {
+                    std::allocator_traits<A>::construct(m_allocator, p, value_type());
+                }
+            }
+            p_end = new_end;
+        }
+        else if (new_size != old_size)
+        {
+            pointer old_begin = p_begin;
+            size_type old_cap = capacity();
             p_begin = detail::safe_init_allocate(m_allocator, new_size);
             p_end = p_begin + new_size;
-            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size);
+            p_capacity = p_end;
+            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size, old_cap);
+        }
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::reallocate_impl(size_type new_cap)
+    {
+        size_type old_size = size();
+        if (new_cap == size_type(0))
+        {
+            detail::safe_destroy_deallocate(m_allocator, p_begin, old_size, capacity());
+            p_begin = nullptr;
+        }
+        else
+        {
+            using use_reallocate = std::integral_constant<bool, detail::has_reallocate<A>::value && std::is_trivial<value_type>::value>;
+            p_begin = detail::reallocate_buffer(m_allocator, p_begin, old_size, capacity(), new_cap, use_reallocate());
+        }
+        p_end = p_begin + old_size;
+        p_capacity = p_begin + new_cap;
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::grow(size_type min_capacity)
+    {
+        size_type new_capacity = 2 * capacity();
+        if (new_capacity < min_capacity)
+        {
+            new_capacity = min_capacity;
         }
+        reallocate_impl(new_capacity);
     }
 
     template <class T, class A>
@@ -235,29 +342,31 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         if (count != 0)
         {
             p_begin = detail::safe_init_allocate(m_allocator, count);
             p_end = p_begin + count;
+            p_capacity = p_end;
         }
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const_reference value, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         if (count != 0)
         {
             p_begin = m_allocator.allocate(count);
             p_end = p_begin + count;
+            p_capacity = p_end;
             std::uninitialized_fill(p_begin, p_end, value);
         }
     }
@@ -265,14 +374,14 @@ namespace xt
     template <class T, class A>
     template <class InputIt, class>
     inline uvector<T, A>::uvector(InputIt first, InputIt last, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(first, last);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(std::initializer_list<T> init, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(init.begin(), init.end());
     }
@@ -280,22 +389,23 @@ namespace xt
     template <class T, class A>
     inline uvector<T, A>::~uvector()
     {
-        detail::safe_destroy_deallocate(m_allocator, p_begin, size());
+        detail::safe_destroy_deallocate(m_allocator, p_begin, size(), capacity());
         p_begin = nullptr;
         p_end = nullptr;
+        p_capacity = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs)
         : m_allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.get_allocator())),
-          p_begin(nullptr), p_end(nullptr)
+          p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
@@ -322,18 +432,20 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs) noexcept
-        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity(rhs.p_capacity)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs, const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity(rhs.p_capacity)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity = nullptr;
     }
 
     template <class T, class A>
@@ -343,6 +455,7 @@ namespace xt
         uvector tmp(std::move(rhs));
         swap(p_begin, tmp.p_begin);
         swap(p_end, tmp.p_end);
+        swap(p_capacity, tmp.p_capacity);
         return *this;
     }
 
@@ -377,19 +490,27 @@ namespace xt
     }
 
     template <class T, class A>
-    inline void uvector<T, A>::reserve(size_type /*new_cap*/)
+    inline void uvector<T, A>::reserve(size_type new_cap)
     {
+        if (new_cap > capacity())
+        {
+            reallocate_impl(new_cap);
+        }
     }
-    
+
     template <class T, class A>
     inline auto uvector<T, A>::capacity() const noexcept -> size_type
     {
-        return size();
+        return static_cast<size_type>(p_capacity - p_begin);
     }
 
     template <class T, class A>
     inline void uvector<T, A>::shrink_to_fit()
     {
+        if (capacity() != size())
+        {
+            reallocate_impl(size());
+        }
     }
 
     template <class T, class A>
@@ -534,6 +655,39 @@ namespace xt
         return rend();
     }
 
+    template <class T, class A>
+    inline void uvector<T, A>::push_back(const_reference value)
+    {
+        if (p_end == p_capacity)
+        {
+            // value may refer to an element of this vector
+            value_type tmp(value);
+            grow(size() + 1);
+            std::allocator_traits<A>::construct(m_allocator, p_end, std::move(tmp));
+        }
+        else
+        {
+            std::allocator_traits<A>::construct(m_allocator, p_end, value);
+        }
+        ++p_end;
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::push_back(value_type&& value)
+    {
+        if (p_end == p_capacity)
+        {
+            value_type tmp(std::move(value));
+            grow(size() + 1);
+            std::allocator_traits<A>::construct(m_allocator, p_end, std::move(tmp));
+        }
+        else
+        {
+            std::allocator_traits<A>::construct(m_allocator, p_end, std::move(value));
+        }
+        ++p_end;
+    }
+
     template <class T, class A>
     inline void uvector<T, A>::swap(uvector<T, A>& rhs) noexcept
     {
@@ -541,6 +695,7 @@ namespace xt
         swap(m_allocator, rhs.m_allocator);
         swap(p_begin, rhs.p_begin);
         swap(p_end, rhs.p_end);
+        swap(p_capacity, rhs.p_capacity);
     }
 
     template <class T, class A>
@@ -586,6 +741,551 @@ namespace xt
         lhs.swap(rhs);
     }
 
+    /***************
+     * cow_uvector *
+     ***************/
+
+    /**
+     * @class cow_uvector
+     * @brief Copy-on-write uvector.
+     *
+     * cow_uvector shares a reference-counted uvector between its copies, so
+     * that copying it costs O(1). The buffer is detached, that is deep copied,
+     * on the first mutable access to a shared buffer. Used as the storage of
+     * a container (see xarray_cow), it makes copies of large arrays that are
+     * only read, such as arrays passed by value to workers, free.
+     *
+     * @warning Any non-const access detaches the buffer, including reads
+     * through non-const containers: read shared arrays through const
+     * references. References and iterators obtained before a copy is made
+     * keep pointing to the shared buffer.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam A The allocator of the underlying uvector.
+     */
+    template <class T, class A = std::allocator<T>>
+    class cow_uvector
+    {
+    public:
+
+        using buffer_type = uvector<T, A>;
+        using allocator_type = typename buffer_type::allocator_type;
+
+        using value_type = typename buffer_type::value_type;
+        using reference = typename buffer_type::reference;
+        using const_reference = typename buffer_type::const_reference;
+        using pointer = typename buffer_type::pointer;
+        using const_pointer = typename buffer_type::const_pointer;
+
+        using size_type = typename buffer_type::size_type;
+        using difference_type = typename buffer_type::difference_type;
+
+        using iterator = typename buffer_type::iterator;
+        using const_iterator = typename buffer_type::const_iterator;
+        using reverse_iterator = typename buffer_type::reverse_iterator;
+        using const_reverse_iterator = typename buffer_type::const_reverse_iterator;
+
+        cow_uvector() noexcept;
+        explicit cow_uvector(const allocator_type& alloc) noexcept;
+        explicit cow_uvector(size_type count, const allocator_type& alloc = allocator_type());
+        cow_uvector(size_type count, const_reference value, const allocator_type& alloc = allocator_type());
+
+        template <class InputIt, class = detail::require_input_iter<InputIt>>
+        cow_uvector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
+
+        cow_uvector(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
+
+        ~cow_uvector();
+
+        cow_uvector(const cow_uvector& rhs) noexcept;
+        cow_uvector& operator=(const cow_uvector& rhs) noexcept;
+
+        cow_uvector(cow_uvector&& rhs) noexcept;
+        cow_uvector& operator=(cow_uvector&& rhs) noexcept;
+
+        allocator_type get_allocator() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        void resize(size_type size);
+        size_type max_size() const noexcept;
+        void reserve(size_type new_cap);
+        size_type capacity() const noexcept;
+        void shrink_to_fit();
+        void clear();
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        reference at(size_type i);
+        const_reference at(size_type i) const;
+
+        reference front();
+        const_reference front() const;
+
+        reference back();
+        const_reference back() const;
+
+        pointer data();
+        const_pointer data() const noexcept;
+
+        iterator begin();
+        iterator end();
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin();
+        reverse_iterator rend();
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void push_back(const_reference value);
+        void push_back(value_type&& value);
+
+        bool is_shared() const noexcept;
+
+        void swap(cow_uvector& rhs) noexcept;
+
+    private:
+
+        // Buffer with an intrusive reference count. The copy that finds
+        // the count equal to one owns the buffer: the acquire load of the
+        // count synchronizes with the release decrements of the copies
+        // that have been destroyed, so that their last reads of the buffer
+        // happen before it is modified.
+        struct shared_buffer
+        {
+            template <class... Args>
+            explicit shared_buffer(Args&&... args);
+
+            buffer_type m_buffer;
+            std::atomic<std::size_t> m_count;
+        };
+
+        template <class... Args>
+        static shared_buffer* make_buffer(Args&&... args);
+
+        const buffer_type& buffer() const noexcept;
+        buffer_type& mutable_buffer();
+        void reset(shared_buffer* buffer = nullptr) noexcept;
+
+        static const buffer_type& empty_buffer() noexcept;
+
+        allocator_type m_allocator;
+        // A null buffer is equivalent to an empty one, which keeps the
+        // default and the moved-from states allocation free.
+        shared_buffer* p_buffer;
+    };
+
+    template <class T, class A>
+    bool operator==(const cow_uvector<T, A>& lhs, const cow_uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator!=(const cow_uvector<T, A>& lhs, const cow_uvector<T, A>& rhs);
+
+    template <class T, class A>
+    void swap(cow_uvector<T, A>& lhs, cow_uvector<T, A>& rhs) noexcept;
+
+    /******************************
+     * cow_uvector implementation *
+     ******************************/
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector() noexcept
+        : cow_uvector(allocator_type())
+    {
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(const allocator_type& alloc) noexcept
+        : m_allocator(alloc), p_buffer(nullptr)
+    {
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(size_type count, const allocator_type& alloc)
+        : m_allocator(alloc), p_buffer(make_buffer(count, alloc))
+    {
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(size_type count, const_reference value, const allocator_type& alloc)
+        : m_allocator(alloc), p_buffer(make_buffer(count, value, alloc))
+    {
+    }
+
+    template <class T, class A>
+    template <class InputIt, class>
+    inline cow_uvector<T, A>::cow_uvector(InputIt first, InputIt last, const allocator_type& alloc)
+        : m_allocator(alloc), p_buffer(make_buffer(first, last, alloc))
+    {
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(std::initializer_list<T> init, const allocator_type& alloc)
+        : m_allocator(alloc), p_buffer(make_buffer(init, alloc))
+    {
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::~cow_uvector()
+    {
+        reset();
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(const cow_uvector& rhs) noexcept
+        : m_allocator(rhs.m_allocator), p_buffer(rhs.p_buffer)
+    {
+        if (p_buffer != nullptr)
+        {
+            // A new reference is made from an existing one,
+            // there is nothing to synchronize with
+            p_buffer->m_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>& cow_uvector<T, A>::operator=(const cow_uvector& rhs) noexcept
+    {
+        cow_uvector tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>::cow_uvector(cow_uvector&& rhs) noexcept
+        : m_allocator(std::move(rhs.m_allocator)), p_buffer(rhs.p_buffer)
+    {
+        rhs.p_buffer = nullptr;
+    }
+
+    template <class T, class A>
+    inline cow_uvector<T, A>& cow_uvector<T, A>::operator=(cow_uvector&& rhs) noexcept
+    {
+        cow_uvector tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    template <class T, class A>
+    template <class... Args>
+    inline cow_uvector<T, A>::shared_buffer::shared_buffer(Args&&... args)
+        : m_buffer(std::forward<Args>(args)...), m_count(1)
+    {
+    }
+
+    template <class T, class A>
+    template <class... Args>
+    inline auto cow_uvector<T, A>::make_buffer(Args&&... args) -> shared_buffer*
+    {
+        return new shared_buffer(std::forward<Args>(args)...);
+    }
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::buffer() const noexcept -> const buffer_type&
+    {
+        return p_buffer != nullptr ? p_buffer->m_buffer : empty_buffer();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::mutable_buffer() -> buffer_type&
+    {
+        if (p_buffer == nullptr)
+        {
+            p_buffer = make_buffer(m_allocator);
+        }
+        else if (is_shared())
+        {
+            reset(make_buffer(p_buffer->m_buffer));
+        }
+        return p_buffer->m_buffer;
+    }
+
+    // Releases the current buffer, the last reference deletes it: the
+    // acquire-release decrement makes the reads of the buffer through the
+    // other references happen before its deletion.
+    template <class T, class A>
+    inline void cow_uvector<T, A>::reset(shared_buffer* buffer) noexcept
+    {
+        if (p_buffer != nullptr && p_buffer->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete p_buffer;
+        }
+        p_buffer = buffer;
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::empty_buffer() noexcept -> const buffer_type&
+    {
+        static const buffer_type res;
+        return res;
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return allocator_type(m_allocator);
+    }
+
+    template <class T, class A>
+    inline bool cow_uvector<T, A>::empty() const noexcept
+    {
+        return buffer().empty();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::size() const noexcept -> size_type
+    {
+        return buffer().size();
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::resize(size_type size)
+    {
+        if (size != this->size())
+        {
+            if (is_shared())
+            {
+                // The elements are not preserved, there is no need to copy them
+                reset(make_buffer(size, m_allocator));
+            }
+            else
+            {
+                mutable_buffer().resize(size);
+            }
+        }
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::max_size() const noexcept -> size_type
+    {
+        return buffer().max_size();
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            mutable_buffer().reserve(new_cap);
+        }
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::capacity() const noexcept -> size_type
+    {
+        return buffer().capacity();
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::shrink_to_fit()
+    {
+        if (capacity() != size())
+        {
+            mutable_buffer().shrink_to_fit();
+        }
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::clear()
+    {
+        reset();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::operator[](size_type i) -> reference
+    {
+        return mutable_buffer()[i];
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::operator[](size_type i) const -> const_reference
+    {
+        return buffer()[i];
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::at(size_type i) -> reference
+    {
+        if (i >= size())
+            XTENSOR_THROW(std::out_of_range, "Out of range in cow_uvector access");
+        return this->operator[](i);
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::at(size_type i) const -> const_reference
+    {
+        if (i >= size())
+            XTENSOR_THROW(std::out_of_range, "Out of range in cow_uvector access");
+        return this->operator[](i);
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::front() -> reference
+    {
+        return mutable_buffer().front();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::front() const -> const_reference
+    {
+        return buffer().front();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::back() -> reference
+    {
+        return mutable_buffer().back();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::back() const -> const_reference
+    {
+        return buffer().back();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::data() -> pointer
+    {
+        return mutable_buffer().data();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::data() const noexcept -> const_pointer
+    {
+        return buffer().data();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::begin() -> iterator
+    {
+        return mutable_buffer().begin();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::end() -> iterator
+    {
+        return mutable_buffer().end();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::begin() const noexcept -> const_iterator
+    {
+        return buffer().begin();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::end() const noexcept -> const_iterator
+    {
+        return buffer().end();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::rbegin() -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::rend() -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return rbegin();
+    }
+
+    template <class T, class A>
+    inline auto cow_uvector<T, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return rend();
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::push_back(const_reference value)
+    {
+        // value may refer to an element of the shared buffer
+        value_type tmp(value);
+        mutable_buffer().push_back(std::move(tmp));
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::push_back(value_type&& value)
+    {
+        mutable_buffer().push_back(std::move(value));
+    }
+
+    /**
+     * Returns true if the buffer is shared with other cow_uvector
+     * objects, in which case the next mutable access copies it.
+     */
+    template <class T, class A>
+    inline bool cow_uvector<T, A>::is_shared() const noexcept
+    {
+        return p_buffer != nullptr && p_buffer->m_count.load(std::memory_order_acquire) > 1;
+    }
+
+    template <class T, class A>
+    inline void cow_uvector<T, A>::swap(cow_uvector<T, A>& rhs) noexcept
+    {
+        using std::swap;
+        swap(m_allocator, rhs.m_allocator);
+        swap(p_buffer, rhs.p_buffer);
+    }
+
+    template <class T, class A>
+    inline bool operator==(const cow_uvector<T, A>& lhs, const cow_uvector<T, A>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class A>
+    inline bool operator!=(const cow_uvector<T, A>& lhs, const cow_uvector<T, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class A>
+    inline void swap(cow_uvector<T, A>& lhs, cow_uvector<T, A>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
     /**************************
      * svector implementation *
      **************************/
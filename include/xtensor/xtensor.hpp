@@ -137,6 +137,12 @@ namespace xt
         template <class E>
         xtensor_container& operator=(const xexpression<E>& e);
 
+        template <class F, class... CT>
+        xtensor_container(xfunction<F, CT...>&& e);
+
+        template <class F, class... CT>
+        xtensor_container& operator=(xfunction<F, CT...>&& e);
+
     private:
 
         storage_type m_storage;
@@ -537,6 +543,44 @@ namespace xt
     {
         return semantic_base::operator=(e);
     }
+
+    /**
+     * The extended move constructor. If an operand of \c e is a temporary
+     * container of the same type as this one and has the shape of \c e, the
+     * expression is evaluated in the buffer of this operand, which is then
+     * moved into the constructed container.
+     */
+    template <class EC, std::size_t N, layout_type L, class Tag>
+    template <class F, class... CT>
+    inline xtensor_container<EC, N, L, Tag>::xtensor_container(xfunction<F, CT...>&& e)
+        : base_type()
+    {
+        if (!detail::reuse_operand_buffer(*this, e))
+        {
+            XTENSOR_ASSERT_MSG(N == e.dimension(), "Cannot change dimension of xtensor.");
+            if (e.dimension() == 0)
+            {
+                detail::resize_data_container(m_storage, std::size_t(1));
+            }
+            semantic_base::assign(e);
+        }
+    }
+
+    /**
+     * The extended move assignment operator. Reuses the buffer of a
+     * temporary operand of \c e when possible, see the extended move
+     * constructor.
+     */
+    template <class EC, std::size_t N, layout_type L, class Tag>
+    template <class F, class... CT>
+    inline auto xtensor_container<EC, N, L, Tag>::operator=(xfunction<F, CT...>&& e) -> self_type&
+    {
+        if (detail::reuse_operand_buffer(*this, e))
+        {
+            return *this;
+        }
+        return semantic_base::operator=(e);
+    }
     //@}
 
     template <class EC, std::size_t N, layout_type L, class Tag>
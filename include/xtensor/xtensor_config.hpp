@@ -65,7 +65,11 @@
 #endif
 
 #ifndef XTENSOR_DEFAULT_ALLOCATOR
-#ifdef XTENSOR_ALLOC_TRACKING
+#if defined(XTENSOR_USE_ARENA_ALLOCATOR)
+    #include "xarena_allocator.hpp"
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::xarena_allocator<T>
+#elif defined(XTENSOR_ALLOC_TRACKING)
     #ifndef XTENSOR_ALLOC_TRACKING_POLICY
         #define XTENSOR_ALLOC_TRACKING_POLICY xt::alloc_tracking::policy::print
     #endif
@@ -109,6 +113,27 @@
 #define XTENSOR_OPENMP_TRESHOLD 0
 #endif
 
+// Number of elements per block in the fused evaluation of zarray expressions
+#ifndef XTENSOR_ZARRAY_BLOCK_SIZE
+#define XTENSOR_ZARRAY_BLOCK_SIZE 1024
+#endif
+
+// Minimum number of elements of a zarray expression evaluated concurrently
+// when xtensor is built with TBB or OpenMP
+#ifndef XTENSOR_ZARRAY_PARALLEL_THRESHOLD
+#define XTENSOR_ZARRAY_PARALLEL_THRESHOLD 65536
+#endif
+
+// Maximum number of intermediate buffers per value type kept by the zarray pool
+#ifndef XTENSOR_ZARRAY_POOL_SIZE
+#define XTENSOR_ZARRAY_POOL_SIZE 16
+#endif
+
+// Maximum number of bytes held by the zarray pool of a thread
+#ifndef XTENSOR_ZARRAY_POOL_BYTES
+#define XTENSOR_ZARRAY_POOL_BYTES (std::size_t(16) << 20)
+#endif
+
 #ifdef IN_DOXYGEN
 namespace xtl
 {
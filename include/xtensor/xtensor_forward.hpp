@@ -44,6 +44,9 @@ namespace xt
     template <class T, class A>
     class uvector;
 
+    template <class T, class A>
+    class cow_uvector;
+
     template <class T, std::size_t N, class A, bool Init>
     class svector;
 
@@ -106,6 +109,24 @@ namespace xt
               class SA = std::allocator<typename std::vector<T, A>::size_type>>
     using xarray_optional = xarray_container<xtl::xoptional_vector<T, A, BC>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA), xoptional_expression_tag>;
 
+    /**
+     * @typedef xarray_cow
+     * Alias template on xarray_container with a copy-on-write data container:
+     * copies share their elements until one of them is modified, so that
+     * copying an array that is only read costs O(1).
+     *
+     * @tparam T The value type of the elements.
+     * @tparam L The layout_type of the container (default: XTENSOR_DEFAULT_LAYOUT).
+     * @tparam A The allocator of the container holding the elements.
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     * @sa cow_uvector
+     */
+    template <class T,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T),
+              class SA = std::allocator<typename std::vector<T, A>::size_type>>
+    using xarray_cow = xarray_container<cow_uvector<T, A>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA)>;
+
     template <class EC, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class Tag = xtensor_expression_tag>
     class xtensor_container;
 
@@ -135,6 +156,25 @@ namespace xt
               class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
     using xtensor = xtensor_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), N, L>;
 
+    template <class EC, std::size_t N, class Tag = xtensor_expression_tag>
+    class xtensor_padded_container;
+
+    /**
+     * @typedef xtensor_padded
+     * Alias template on xtensor_padded_container with default parameters for
+     * data container type. The rows of the tensor are padded so that each of
+     * them starts on an aligned address.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The dimension of the tensor.
+     * @tparam A The allocator of the containers holding the elements.
+     * @sa xtensor_padded_container
+     */
+    template <class T,
+              std::size_t N,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
+    using xtensor_padded = xtensor_padded_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), N>;
+
     template <class EC, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class Tag = xtensor_expression_tag>
     class xtensor_adaptor;
 
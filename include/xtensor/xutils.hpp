@@ -12,14 +12,19 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -718,11 +723,305 @@ namespace xt
         enum policy
         {
             print,
-            assert
+            assert,
+            stats
         };
+
+        constexpr std::size_t histogram_size = 8 * sizeof(std::size_t) + 1;
+
+        /**
+         * Allocation statistics collected by tracking allocators with the
+         * stats policy. The entry i of the histogram counts the allocations
+         * of n bytes where 2^(i-1) <= n < 2^i (the first entry counts empty
+         * allocations). The peak of live bytes is exact when the allocations
+         * are made by a single thread; otherwise, it is an upper bound, the
+         * sum of the peaks observed by the stripes of the counters.
+         */
+        struct alloc_stats
+        {
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
+            std::size_t allocated_bytes = 0;
+            std::size_t live_bytes = 0;
+            std::size_t peak_live_bytes = 0;
+            std::array<std::size_t, histogram_size> size_histogram = {};
+        };
+
+        std::map<std::string, alloc_stats> snapshot();
+        alloc_stats total();
+        void reset();
+
+        namespace detail
+        {
+            // Number of stripes of the counters: the threads are spread
+            // over the stripes, so that concurrent allocations do not
+            // contend on the same cache lines.
+            constexpr std::size_t alloc_nb_stripes = 32;
+
+            class alloc_counters
+            {
+            public:
+
+                void record_allocation(std::size_t stripe, std::size_t bytes) noexcept;
+                void record_deallocation(std::size_t stripe, std::size_t bytes) noexcept;
+
+                alloc_stats load() const noexcept;
+                void reset() noexcept;
+
+            private:
+
+                // The live bytes of a stripe are negative when its threads
+                // deallocate blocks allocated by threads of other stripes.
+                struct stripe
+                {
+                    std::atomic<std::size_t> m_allocations{0};
+                    std::atomic<std::size_t> m_deallocations{0};
+                    std::atomic<std::size_t> m_allocated_bytes{0};
+                    std::atomic<std::ptrdiff_t> m_live_bytes{0};
+                    std::atomic<std::ptrdiff_t> m_peak_live_bytes{0};
+                    std::array<std::atomic<std::size_t>, histogram_size> m_size_histogram{};
+                    // Keeps the next stripe off the last cache line of this one
+                    char m_padding[64];
+                };
+
+                std::array<stripe, alloc_nb_stripes> m_stripes;
+            };
+
+            class alloc_registry
+            {
+            public:
+
+                using entry_type = std::pair<std::string, std::unique_ptr<alloc_counters>>;
+
+                static alloc_registry& instance();
+
+                alloc_counters& add(const char* name);
+                alloc_counters& global() noexcept;
+
+                std::map<std::string, alloc_stats> snapshot();
+                void reset();
+
+            private:
+
+                alloc_registry() = default;
+
+                std::mutex m_mutex;
+                std::vector<entry_type> m_entries;
+                alloc_counters m_global;
+            };
+
+            inline std::size_t histogram_bucket(std::size_t bytes) noexcept
+            {
+                std::size_t res = 0;
+                while (bytes != 0)
+                {
+                    ++res;
+                    bytes >>= 1;
+                }
+                return res;
+            }
+
+            // Stripe of the calling thread, the threads are
+            // assigned to the stripes in a round robin fashion
+            inline std::size_t alloc_stripe_index() noexcept
+            {
+                static std::atomic<std::size_t> next(0);
+                thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % alloc_nb_stripes;
+                return index;
+            }
+
+            inline void alloc_counters::record_allocation(std::size_t stripe_index, std::size_t bytes) noexcept
+            {
+                stripe& st = m_stripes[stripe_index];
+                st.m_allocations.fetch_add(1, std::memory_order_relaxed);
+                st.m_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                st.m_size_histogram[histogram_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+                std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(bytes);
+                std::ptrdiff_t live = st.m_live_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+                std::ptrdiff_t peak = st.m_peak_live_bytes.load(std::memory_order_relaxed);
+                while (live > peak && !st.m_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            inline void alloc_counters::record_deallocation(std::size_t stripe_index, std::size_t bytes) noexcept
+            {
+                stripe& st = m_stripes[stripe_index];
+                st.m_deallocations.fetch_add(1, std::memory_order_relaxed);
+                st.m_live_bytes.fetch_sub(static_cast<std::ptrdiff_t>(bytes), std::memory_order_relaxed);
+            }
+
+            inline alloc_stats alloc_counters::load() const noexcept
+            {
+                alloc_stats res;
+                std::ptrdiff_t live = 0;
+                std::ptrdiff_t peak = 0;
+                for (const stripe& st : m_stripes)
+                {
+                    res.allocations += st.m_allocations.load(std::memory_order_relaxed);
+                    res.deallocations += st.m_deallocations.load(std::memory_order_relaxed);
+                    res.allocated_bytes += st.m_allocated_bytes.load(std::memory_order_relaxed);
+                    live += st.m_live_bytes.load(std::memory_order_relaxed);
+                    peak += st.m_peak_live_bytes.load(std::memory_order_relaxed);
+                    for (std::size_t i = 0; i < histogram_size; ++i)
+                    {
+                        res.size_histogram[i] += st.m_size_histogram[i].load(std::memory_order_relaxed);
+                    }
+                }
+                res.live_bytes = live > 0 ? static_cast<std::size_t>(live) : std::size_t(0);
+                res.peak_live_bytes = std::max(static_cast<std::size_t>(peak), res.live_bytes);
+                return res;
+            }
+
+            inline void alloc_counters::reset() noexcept
+            {
+                // Live bytes are kept so that later deallocations remain consistent
+                for (stripe& st : m_stripes)
+                {
+                    st.m_allocations.store(0, std::memory_order_relaxed);
+                    st.m_deallocations.store(0, std::memory_order_relaxed);
+                    st.m_allocated_bytes.store(0, std::memory_order_relaxed);
+                    std::ptrdiff_t live = st.m_live_bytes.load(std::memory_order_relaxed);
+                    st.m_peak_live_bytes.store(std::max(live, std::ptrdiff_t(0)), std::memory_order_relaxed);
+                    for (auto& count : st.m_size_histogram)
+                    {
+                        count.store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            inline alloc_registry& alloc_registry::instance()
+            {
+                static alloc_registry registry;
+                return registry;
+            }
+
+            inline alloc_counters& alloc_registry::add(const char* name)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_entries.emplace_back(name, std::make_unique<alloc_counters>());
+                return *(m_entries.back().second);
+            }
+
+            inline alloc_counters& alloc_registry::global() noexcept
+            {
+                return m_global;
+            }
+
+            inline std::map<std::string, alloc_stats> alloc_registry::snapshot()
+            {
+                std::map<std::string, alloc_stats> res;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (const auto& entry : m_entries)
+                {
+                    // A name registered by several value types or shared libraries shows up once
+                    alloc_stats st = entry.second->load();
+                    alloc_stats& acc = res[entry.first];
+                    acc.allocations += st.allocations;
+                    acc.deallocations += st.deallocations;
+                    acc.allocated_bytes += st.allocated_bytes;
+                    acc.live_bytes += st.live_bytes;
+                    acc.peak_live_bytes += st.peak_live_bytes;
+                    for (std::size_t i = 0; i < histogram_size; ++i)
+                    {
+                        acc.size_histogram[i] += st.size_histogram[i];
+                    }
+                }
+                return res;
+            }
+
+            inline void alloc_registry::reset()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto& entry : m_entries)
+                {
+                    entry.second->reset();
+                }
+                m_global.reset();
+            }
+
+            // Name of the statistics of a tracking allocator: the name
+            // of its tag, or the name of its value type by default
+            template <class Tag, class T>
+            struct alloc_tag_name
+            {
+                static const char* get()
+                {
+                    return Tag::name();
+                }
+            };
+
+            template <class T>
+            struct alloc_tag_name<void, T>
+            {
+                static const char* get()
+                {
+                    return typeid(T).name();
+                }
+            };
+
+            template <class Tag, class T>
+            inline alloc_counters& tagged_counters()
+            {
+                static alloc_counters& counters = alloc_registry::instance().add(alloc_tag_name<Tag, T>::get());
+                return counters;
+            }
+
+            template <class Tag, class T>
+            inline void record_allocation(std::size_t bytes)
+            {
+                std::size_t stripe = alloc_stripe_index();
+                tagged_counters<Tag, T>().record_allocation(stripe, bytes);
+                alloc_registry::instance().global().record_allocation(stripe, bytes);
+            }
+
+            template <class Tag, class T>
+            inline void record_deallocation(std::size_t bytes)
+            {
+                std::size_t stripe = alloc_stripe_index();
+                tagged_counters<Tag, T>().record_deallocation(stripe, bytes);
+                alloc_registry::instance().global().record_deallocation(stripe, bytes);
+            }
+        }
+
+        /**
+         * Returns the statistics of the allocations made by tracking
+         * allocators with the stats policy, per name. The name of an
+         * allocator is given by its tag, or is the (implementation
+         * defined) name of its value type if it has none.
+         */
+        inline std::map<std::string, alloc_stats> snapshot()
+        {
+            return detail::alloc_registry::instance().snapshot();
+        }
+
+        /**
+         * Returns the statistics of all the allocations made by tracking
+         * allocators with the stats policy.
+         */
+        inline alloc_stats total()
+        {
+            return detail::alloc_registry::instance().global().load();
+        }
+
+        /**
+         * Resets the allocation statistics. The live bytes are preserved,
+         * and the peaks restart from them.
+         */
+        inline void reset()
+        {
+            detail::alloc_registry::instance().reset();
+        }
     }
 
-    template <class T, class A, alloc_tracking::policy P>
+    /**
+     * Allocator tracking the allocations of \c A according to the policy \c P.
+     * With the stats policy, the statistics are collected under the name
+     * returned by the static function \c Tag::name(), so that the
+     * containers of the same value type can be told apart; they are
+     * collected under the name of the value type if \c Tag is void.
+     */
+    template <class T, class A, alloc_tracking::policy P, class Tag = void>
     struct tracking_allocator
         : private A
     {
@@ -739,7 +1038,14 @@ namespace xt
 
         T* allocate(std::size_t n)
         {
-            if (alloc_tracking::enabled())
+            if (P == alloc_tracking::stats)
+            {
+                // Statistics are always collected, regardless of alloc_tracking::enabled
+                T* res = base_type::allocate(n);
+                alloc_tracking::detail::record_allocation<Tag, T>(n * sizeof(T));
+                return res;
+            }
+            else if (alloc_tracking::enabled())
             {
                 if (P == alloc_tracking::print)
                 {
@@ -755,7 +1061,15 @@ namespace xt
             return base_type::allocate(n);
         }
 
-        using base_type::deallocate;
+        void deallocate(T* p, std::size_t n)
+        {
+            if (P == alloc_tracking::stats)
+            {
+                alloc_tracking::detail::record_deallocation<Tag, T>(n * sizeof(T));
+            }
+            base_type::deallocate(p, n);
+        }
+
         using base_type::construct;
         using base_type::destroy;
 
@@ -763,18 +1077,18 @@ namespace xt
         struct rebind
         {
             using traits = std::allocator_traits<A>;
-            using other = tracking_allocator<U, typename traits::template rebind_alloc<U>, P>;
+            using other = tracking_allocator<U, typename traits::template rebind_alloc<U>, P, Tag>;
         };
     };
 
-    template <class T, class AT, alloc_tracking::policy PT, class U, class AU, alloc_tracking::policy PU>
-    inline bool operator==(const tracking_allocator<T, AT, PT>&, const tracking_allocator<U, AU, PU>&)
+    template <class T, class AT, alloc_tracking::policy PT, class TT, class U, class AU, alloc_tracking::policy PU, class TU>
+    inline bool operator==(const tracking_allocator<T, AT, PT, TT>&, const tracking_allocator<U, AU, PU, TU>&)
     {
       return std::is_same<AT, AU>::value;
     }
 
-    template <class T, class AT, alloc_tracking::policy PT, class U, class AU, alloc_tracking::policy PU>
-    inline bool operator!=(const tracking_allocator<T, AT, PT>& a, const tracking_allocator<U, AU, PU>& b)
+    template <class T, class AT, alloc_tracking::policy PT, class TT, class U, class AU, alloc_tracking::policy PU, class TU>
+    inline bool operator!=(const tracking_allocator<T, AT, PT, TT>& a, const tracking_allocator<U, AU, PU, TU>& b)
     {
       return !(a == b);
     }
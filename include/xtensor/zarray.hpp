@@ -59,8 +59,12 @@ namespace xt
         template <class E>
         zarray& operator=(const xexpression<E>&);
 
+        template <class E>
+        zarray& operator=(xexpression<E>&&);
+
         void swap(zarray& rhs);
 
+        bool has_implementation() const noexcept;
         zarray_impl& get_implementation();
         const zarray_impl& get_implementation() const;
 
@@ -78,9 +82,15 @@ namespace xt
         template <class E>
         void init_implementation(const xexpression<E>& e, zarray_expression_tag);
 
+        template <class E>
+        void init_implementation(xexpression<E>&& e, zarray_expression_tag);
+
         implementation_ptr p_impl;
     };
 
+    zarray zstrided_view(const zarray& e, const xstrided_slice_vector& slices);
+    zarray zstrided_view(zarray&& e, const xstrided_slice_vector& slices);
+
     /*************************
      * zarray implementation *
      *************************/
@@ -97,6 +107,25 @@ namespace xt
         p_impl = nullptr;
         semantic_base::assign(e);
     }
+
+    // The expression is an rvalue, so are the zarray operands it holds
+    // by value: the result is computed in place into the buffer of one
+    // of them when possible, which avoids allocating the result.
+    template <class E>
+    inline void zarray::init_implementation(xexpression<E>&& e, zarray_expression_tag)
+    {
+        E& de = e.derived_cast();
+        zarray* operand = de.get_reusable_operand();
+        if (operand != nullptr)
+        {
+            de.assign_to(operand->get_implementation());
+            p_impl = std::move(operand->p_impl);
+        }
+        else
+        {
+            init_implementation(static_cast<const xexpression<E>&>(e), zarray_expression_tag());
+        }
+    }
     
     template <class E>
     inline zarray::zarray(E&& e)
@@ -143,12 +172,25 @@ namespace xt
     {
         return semantic_base::operator=(e);
     }
+
+    template <class E>
+    inline zarray& zarray::operator=(xexpression<E>&& e)
+    {
+        zarray tmp(std::move(e).derived_cast());
+        swap(tmp);
+        return *this;
+    }
     
     inline void zarray::swap(zarray& rhs)
     {
         std::swap(p_impl, rhs.p_impl);
     }
 
+    inline bool zarray::has_implementation() const noexcept
+    {
+        return p_impl != nullptr;
+    }
+
     inline zarray_impl& zarray::get_implementation()
     {
         return *p_impl;
@@ -170,6 +212,42 @@ namespace xt
     {
         return dynamic_cast<const ztyped_array<T>*>(p_impl.get())->get_array();
     }
+
+    /**
+     * Returns a zarray viewing the elements of \c e selected by \c slices,
+     * without copying them. Operations on the returned zarray read the
+     * buffer of \c e in place. Like xt::strided_view, the view does not
+     * extend the lifetime of \c e unless \c e is itself a view: it is
+     * invalidated when \c e is destroyed, and when the implementation of
+     * \c e is replaced, that is, by any assignment to \c e other than
+     * noalias(e) = f and e += f when the result is written in place.
+     * Use the rvalue overload to share the buffer with the view.
+     * @param e the zarray to view
+     * @param slices the slices (ranges, indices, newaxis, all, ellipsis)
+     * @return a zarray holding a view on the buffer of \c e
+     */
+    inline zarray zstrided_view(const zarray& e, const xstrided_slice_vector& slices)
+    {
+        const zarray_impl& impl = e.get_implementation();
+        std::shared_ptr<const zarray_impl> base(std::shared_ptr<const zarray_impl>(), &impl);
+        return zarray(zarray::implementation_ptr(impl.strided_view(base, slices)));
+    }
+
+    /**
+     * Returns a zarray viewing the elements of \c e selected by \c slices.
+     * The buffer of \c e is moved into a shared holder, it is released
+     * when the last view on it is destroyed.
+     * @param e the zarray to view
+     * @param slices the slices (ranges, indices, newaxis, all, ellipsis)
+     * @return a zarray holding a view on the buffer of \c e
+     */
+    inline zarray zstrided_view(zarray&& e, const xstrided_slice_vector& slices)
+    {
+        auto holder = std::make_shared<zarray>(std::move(e));
+        const zarray_impl& impl = holder->get_implementation();
+        std::shared_ptr<const zarray_impl> base(holder, &impl);
+        return zarray(zarray::implementation_ptr(impl.strided_view(base, slices)));
+    }
 }
 
 #endif
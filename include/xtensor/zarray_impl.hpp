@@ -10,7 +10,15 @@
 #ifndef XTENSOR_ZARRAY_IMPL_HPP
 #define XTENSOR_ZARRAY_IMPL_HPP
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "xarray.hpp"
+#include "xbroadcast.hpp"
+#include "xchunked_array.hpp"
+#include "xstrided_view.hpp"
 
 namespace xt
 {
@@ -51,6 +59,7 @@ namespace xt
     public:
 
         using self_type = zarray_impl;
+        using shape_type = dynamic_shape<std::size_t>;
 
         virtual ~zarray_impl() = default;
 
@@ -60,6 +69,51 @@ namespace xt
 
         virtual self_type* clone() const = 0;
 
+        // Returns true if the data does not belong to an
+        // expression or a container external to the zarray.
+        virtual bool owns_data() const noexcept = 0;
+
+        virtual const shape_type& shape() const = 0;
+        virtual void resize(const shape_type& shape) = 0;
+
+        // Returns the size in bytes of an element.
+        virtual std::size_t value_size() const noexcept = 0;
+
+        // Block transfers used by the fused evaluation of zfunction
+        // trees: block must hold the same value type as this array.
+        virtual void get_block(self_type& block, std::size_t offset, std::size_t size) const = 0;
+        virtual void set_block(const self_type& block, std::size_t offset) = 0;
+
+        // Reads the block [offset, offset + size) of the broadcast of this
+        // array to shape, which is the shape of the evaluated tree.
+        virtual void get_broadcast_block(self_type& block,
+                                         const shape_type& shape,
+                                         std::size_t offset,
+                                         std::size_t size) const = 0;
+
+        // Computes the lazily evaluated content of the array, if any, so
+        // that get_array and get_block can then be called concurrently.
+        virtual void materialize() const = 0;
+
+        // Returns true if the elements are read through a strided
+        // view on the buffer of another implementation.
+        virtual bool is_view() const noexcept = 0;
+
+        // Returns true if the elements are stored in chunks, so that
+        // get_array returns a copy of them instead of the actual storage.
+        virtual bool is_chunked() const noexcept = 0;
+
+        // Returns true if the result of an assignment to the zarray may be
+        // written into the container it refers to although it does not own
+        // it. Otherwise, such a container is never written to.
+        virtual bool accepts_in_place_result() const noexcept = 0;
+
+        // Returns a new implementation viewing the elements of this array
+        // selected by slices, without copying them; base is the pointer
+        // that keeps this array alive for the lifetime of the view.
+        virtual self_type* strided_view(const std::shared_ptr<const self_type>& base,
+                                        const xstrided_slice_vector& slices) const = 0;
+
         XTL_IMPLEMENT_INDEXABLE_CLASS()
 
     protected:
@@ -77,11 +131,32 @@ namespace xt
     {
     public:
 
+        using base_type = zarray_impl;
+        using shape_type = base_type::shape_type;
+
         virtual ~ztyped_array() = default;
 
         virtual xarray<T>& get_array() = 0;
         virtual const xarray<T>& get_array() const = 0;
 
+        const shape_type& shape() const override;
+        void resize(const shape_type& shape) override;
+        std::size_t value_size() const noexcept override;
+
+        void get_block(base_type& block, std::size_t offset, std::size_t size) const override;
+        void set_block(const base_type& block, std::size_t offset) override;
+        void get_broadcast_block(base_type& block,
+                                 const shape_type& shape,
+                                 std::size_t offset,
+                                 std::size_t size) const override;
+        void materialize() const override;
+
+        bool is_view() const noexcept override;
+        bool is_chunked() const noexcept override;
+        bool accepts_in_place_result() const noexcept override;
+        base_type* strided_view(const std::shared_ptr<const base_type>& base,
+                                const xstrided_slice_vector& slices) const override;
+
         XTL_IMPLEMENT_INDEXABLE_CLASS()
 
     protected:
@@ -112,6 +187,7 @@ namespace xt
         const xarray<value_type>& get_array() const override;
 
         self_type* clone() const override;
+        bool owns_data() const noexcept override;
 
     private:
 
@@ -146,6 +222,7 @@ namespace xt
         const xarray<value_type>& get_array() const override;
 
         self_type* clone() const override;
+        bool owns_data() const noexcept override;
 
     private:
 
@@ -154,6 +231,237 @@ namespace xt
         CTE m_array;
     };
 
+    /********************
+     * zchunked_wrapper *
+     ********************/
+
+    // Wrapper on an xchunked_array, whose chunks may be stored on disk.
+    // The block transfers used by the fused evaluation of zfunction trees
+    // read and write the chunks directly, one contiguous range of a chunk
+    // at a time, so that a tree whose leaves and result are chunked arrays
+    // is evaluated with bounded memory. The blocks follow the layout of the
+    // whole array: the chunk pool of a chunk store should hold a row of
+    // chunks to avoid reloading them. Unlike a wrapped xarray, a chunked
+    // array held by reference receives the result of an assignment to the
+    // zarray, since that is how it is filled.
+    template <class CTE>
+    class zchunked_wrapper : public ztyped_array<typename std::decay_t<CTE>::value_type>
+    {
+    public:
+
+        using self_type = zchunked_wrapper<CTE>;
+        using value_type = typename std::decay_t<CTE>::value_type;
+        using base_type = ztyped_array<value_type>;
+        using shape_type = typename base_type::shape_type;
+        using chunk_storage_type = typename std::decay_t<CTE>::chunk_storage_type;
+
+        template <class E>
+        zchunked_wrapper(E&& e);
+
+        virtual ~zchunked_wrapper() = default;
+
+        // The returned array is a copy of the whole chunked array,
+        // computed once: modifying it does not modify the chunks.
+        xarray<value_type>& get_array() override;
+        const xarray<value_type>& get_array() const override;
+
+        self_type* clone() const override;
+        bool owns_data() const noexcept override;
+        bool is_chunked() const noexcept override;
+        bool accepts_in_place_result() const noexcept override;
+
+        const shape_type& shape() const override;
+        void resize(const shape_type& shape) override;
+
+        void get_block(zarray_impl& block, std::size_t offset, std::size_t size) const override;
+        void set_block(const zarray_impl& block, std::size_t offset) override;
+
+    private:
+
+        zchunked_wrapper(const zchunked_wrapper&) = default;
+
+        void compute_cache() const;
+
+        template <class F>
+        void for_each_chunk_range(std::size_t offset, std::size_t size, F&& f) const;
+
+        CTE m_array;
+        shape_type m_shape;
+        shape_type m_chunk_strides;
+        mutable xarray<value_type> m_cache;
+        mutable bool m_cache_initialized;
+    };
+
+    /*****************
+     * zview_wrapper *
+     *****************/
+
+    // Strided view on the buffer of another ztyped_array, which is shared
+    // with the view. zview_wrapper does not implement its own class index,
+    // so that views and containers of the same value type are dispatched
+    // to the same functor. The view refers to the buffer of the viewed
+    // implementation: it is invalidated if that implementation is
+    // destroyed, e.g. replaced by an assignment to the viewed zarray that
+    // does not write into it in place (see zstrided_view).
+    template <class T>
+    class zview_wrapper : public ztyped_array<T>
+    {
+    public:
+
+        using self_type = zview_wrapper<T>;
+        using base_type = ztyped_array<T>;
+        using shape_type = typename base_type::shape_type;
+        using holder_type = std::shared_ptr<const zarray_impl>;
+        using view_type = xstrided_view<const xarray<T>&, shape_type>;
+        using strides_type = typename view_type::strides_type;
+
+        zview_wrapper(const holder_type& base,
+                      shape_type&& shape,
+                      strides_type&& strides,
+                      std::size_t offset,
+                      layout_type layout);
+
+        virtual ~zview_wrapper() = default;
+
+        // The returned array is a copy of the viewed elements, computed
+        // once on the first call: it does not reflect later modifications
+        // of the underlying array, and modifying it does not modify the
+        // underlying array. Functors and block transfers read the view in
+        // place through get_view instead.
+        xarray<T>& get_array() override;
+        const xarray<T>& get_array() const override;
+
+        const view_type& get_view() const noexcept;
+
+        self_type* clone() const override;
+        bool owns_data() const noexcept override;
+
+        const shape_type& shape() const override;
+        void resize(const shape_type& shape) override;
+
+        void get_block(zarray_impl& block, std::size_t offset, std::size_t size) const override;
+        void set_block(const zarray_impl& block, std::size_t offset) override;
+        void get_broadcast_block(zarray_impl& block,
+                                 const shape_type& shape,
+                                 std::size_t offset,
+                                 std::size_t size) const override;
+        void materialize() const override;
+
+        bool is_view() const noexcept override;
+        zarray_impl* strided_view(const holder_type& base,
+                                  const xstrided_slice_vector& slices) const override;
+
+    private:
+
+        zview_wrapper(const zview_wrapper& rhs);
+
+        void compute_cache() const;
+
+        holder_type p_base;
+        view_type m_view;
+        mutable xarray<T> m_cache;
+        mutable std::once_flag m_cache_flag;
+    };
+
+    /****************
+     * ztyped_array *
+     ****************/
+
+    template <class T>
+    inline auto ztyped_array<T>::shape() const -> const shape_type&
+    {
+        return get_array().shape();
+    }
+
+    template <class T>
+    inline void ztyped_array<T>::resize(const shape_type& shape)
+    {
+        get_array().resize(shape);
+    }
+
+    template <class T>
+    inline std::size_t ztyped_array<T>::value_size() const noexcept
+    {
+        return sizeof(T);
+    }
+
+    template <class T>
+    inline void ztyped_array<T>::get_block(base_type& block, std::size_t offset, std::size_t size) const
+    {
+        xarray<T>& dst = static_cast<ztyped_array<T>&>(block).get_array();
+        dst.resize({size});
+        const T* first = get_array().data() + offset;
+        std::copy(first, first + size, dst.data());
+    }
+
+    template <class T>
+    inline void ztyped_array<T>::set_block(const base_type& block, std::size_t offset)
+    {
+        const xarray<T>& src = static_cast<const ztyped_array<T>&>(block).get_array();
+        std::copy(src.data(), src.data() + src.size(), get_array().data() + offset);
+    }
+
+    // The elements of a broadcast block are gathered from the buffer
+    // returned by get_array: a leaf is broadcast only when it is smaller
+    // than the result along some axis, so a chunked leaf may be loaded
+    // as a whole in that case, but the result never is.
+    template <class T>
+    inline void ztyped_array<T>::get_broadcast_block(base_type& block,
+                                                     const shape_type& shape,
+                                                     std::size_t offset,
+                                                     std::size_t size) const
+    {
+        if (this->shape() == shape)
+        {
+            get_block(block, offset, size);
+            return;
+        }
+        xarray<T>& dst = static_cast<ztyped_array<T>&>(block).get_array();
+        dst.resize({size});
+        auto broadcasted = xt::broadcast(get_array(), shape);
+        auto first = broadcasted.template cbegin<XTENSOR_DEFAULT_LAYOUT>();
+        first += static_cast<std::ptrdiff_t>(offset);
+        std::copy_n(first, size, dst.data());
+    }
+
+    template <class T>
+    inline void ztyped_array<T>::materialize() const
+    {
+        get_array();
+    }
+
+    template <class T>
+    inline bool ztyped_array<T>::is_view() const noexcept
+    {
+        return false;
+    }
+
+    template <class T>
+    inline bool ztyped_array<T>::is_chunked() const noexcept
+    {
+        return false;
+    }
+
+    template <class T>
+    inline bool ztyped_array<T>::accepts_in_place_result() const noexcept
+    {
+        return false;
+    }
+
+    template <class T>
+    inline auto ztyped_array<T>::strided_view(const std::shared_ptr<const base_type>& base,
+                                              const xstrided_slice_vector& slices) const -> base_type*
+    {
+        const xarray<T>& a = get_array();
+        detail::strided_view_args<detail::no_adj_strides_policy> args;
+        args.fill_args(a.shape(), a.strides(), 0, a.layout(), slices);
+        return new zview_wrapper<T>(base,
+                                    std::move(args.new_shape),
+                                    std::move(args.new_strides),
+                                    args.new_offset,
+                                    args.new_layout);
+    }
+
     /***********************
      * zexpression_wrapper *
      ***********************/
@@ -188,6 +496,12 @@ namespace xt
         return new self_type(*this);
     }
 
+    template <class CTE>
+    inline bool zexpression_wrapper<CTE>::owns_data() const noexcept
+    {
+        return true;
+    }
+
     template <class CTE>
     inline void zexpression_wrapper<CTE>::compute_cache() const
     {
@@ -228,6 +542,359 @@ namespace xt
         return new self_type(*this);
     }
 
+    template <class CTE>
+    inline bool zarray_wrapper<CTE>::owns_data() const noexcept
+    {
+        return !std::is_reference<CTE>::value;
+    }
+
+    /********************
+     * zchunked_wrapper *
+     ********************/
+
+    template <class CTE>
+    template <class E>
+    inline zchunked_wrapper<CTE>::zchunked_wrapper(E&& e)
+        : base_type()
+        , m_array(std::forward<E>(e))
+        , m_shape(m_array.shape().cbegin(), m_array.shape().cend())
+        , m_chunk_strides(m_shape.size())
+        , m_cache()
+        , m_cache_initialized(false)
+    {
+        // Chunks are contiguous arrays with the default layout
+        const auto& chunk_shape = m_array.chunk_shape();
+        std::size_t dim = m_shape.size();
+        std::size_t stride = 1;
+        for (std::size_t k = dim; k != 0; --k)
+        {
+            std::size_t d = XTENSOR_DEFAULT_LAYOUT == layout_type::row_major ? k - 1 : dim - k;
+            m_chunk_strides[d] = stride;
+            stride *= chunk_shape[d];
+        }
+    }
+
+    template <class CTE>
+    inline auto zchunked_wrapper<CTE>::get_array() -> xarray<value_type>&
+    {
+        compute_cache();
+        return m_cache;
+    }
+
+    template <class CTE>
+    inline auto zchunked_wrapper<CTE>::get_array() const -> const xarray<value_type>&
+    {
+        compute_cache();
+        return m_cache;
+    }
+
+    template <class CTE>
+    inline auto zchunked_wrapper<CTE>::clone() const -> self_type*
+    {
+        return new self_type(*this);
+    }
+
+    template <class CTE>
+    inline bool zchunked_wrapper<CTE>::owns_data() const noexcept
+    {
+        return !std::is_reference<CTE>::value;
+    }
+
+    template <class CTE>
+    inline bool zchunked_wrapper<CTE>::is_chunked() const noexcept
+    {
+        return true;
+    }
+
+    template <class CTE>
+    inline bool zchunked_wrapper<CTE>::accepts_in_place_result() const noexcept
+    {
+        return true;
+    }
+
+    template <class CTE>
+    inline auto zchunked_wrapper<CTE>::shape() const -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class CTE>
+    inline void zchunked_wrapper<CTE>::resize(const shape_type& shape)
+    {
+        if (shape != m_shape)
+        {
+            XTENSOR_THROW(std::runtime_error, "cannot resize a chunked zarray");
+        }
+    }
+
+    template <class CTE>
+    inline void zchunked_wrapper<CTE>::get_block(zarray_impl& block, std::size_t offset, std::size_t size) const
+    {
+        xarray<value_type>& dst = static_cast<base_type&>(block).get_array();
+        dst.resize({size});
+        value_type* out = dst.data();
+        for_each_chunk_range(offset, size, [out](auto& chunk, std::size_t first, std::size_t pos, std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[pos + i] = chunk.data_element(first + i);
+            }
+        });
+    }
+
+    template <class CTE>
+    inline void zchunked_wrapper<CTE>::set_block(const zarray_impl& block, std::size_t offset)
+    {
+        const xarray<value_type>& src = static_cast<const base_type&>(block).get_array();
+        const value_type* in = src.data();
+        // Chunks are written through data_element, so that chunks
+        // stored on disk are marked as modified
+        for_each_chunk_range(offset, src.size(), [in](auto& chunk, std::size_t first, std::size_t pos, std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                chunk.data_element(first + i) = in[pos + i];
+            }
+        });
+        m_cache_initialized = false;
+    }
+
+    template <class CTE>
+    inline void zchunked_wrapper<CTE>::compute_cache() const
+    {
+        if (!m_cache_initialized)
+        {
+            m_cache.resize(m_shape);
+            if (m_cache.size() != 0)
+            {
+                value_type* out = m_cache.data();
+                for_each_chunk_range(0, m_cache.size(), [out](auto& chunk, std::size_t first, std::size_t pos, std::size_t n)
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[pos + i] = chunk.data_element(first + i);
+                    }
+                });
+            }
+            m_cache_initialized = true;
+        }
+    }
+
+    // Calls f(chunk, first, pos, n) for each range of n elements of the
+    // block [offset, offset + size) that is contiguous in a chunk: first
+    // is the position of the range in the chunk, and pos its position
+    // in the block. Each chunk is looked up once per range, instead of
+    // once per element as with the iterators of xchunked_array.
+    template <class CTE>
+    template <class F>
+    inline void zchunked_wrapper<CTE>::for_each_chunk_range(std::size_t offset, std::size_t size, F&& f) const
+    {
+        // Loading a chunk in the pool of a chunk store
+        // does not modify the elements of the array
+        chunk_storage_type& chunks = const_cast<chunk_storage_type&>(m_array.chunks());
+        const auto& chunk_shape = m_array.chunk_shape();
+        std::size_t dim = m_shape.size();
+        if (dim == 0)
+        {
+            std::vector<std::size_t> chunk_index;
+            f(chunks.element(chunk_index.cbegin(), chunk_index.cend()), std::size_t(0), std::size_t(0), size);
+            return;
+        }
+
+        // k-th dimension in the order of the layout, the last one being the innermost
+        auto axis = [dim](std::size_t k)
+        {
+            return XTENSOR_DEFAULT_LAYOUT == layout_type::row_major ? k : dim - 1 - k;
+        };
+
+        std::vector<std::size_t> index(dim);
+        std::vector<std::size_t> chunk_index(dim);
+        std::size_t remainder = offset;
+        for (std::size_t k = dim; k != 0; --k)
+        {
+            std::size_t d = axis(k - 1);
+            index[d] = remainder % m_shape[d];
+            remainder /= m_shape[d];
+        }
+
+        std::size_t inner = axis(dim - 1);
+        std::size_t pos = 0;
+        while (pos < size)
+        {
+            std::size_t first = 0;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                chunk_index[d] = index[d] / chunk_shape[d];
+                first += (index[d] - chunk_index[d] * chunk_shape[d]) * m_chunk_strides[d];
+            }
+            std::size_t in_chunk = chunk_shape[inner] - index[inner] % chunk_shape[inner];
+            std::size_t n = std::min(std::min(size - pos, in_chunk), m_shape[inner] - index[inner]);
+            f(chunks.element(chunk_index.cbegin(), chunk_index.cend()), first, pos, n);
+            pos += n;
+
+            index[inner] += n;
+            for (std::size_t k = dim - 1; k != 0 && index[axis(k)] == m_shape[axis(k)]; --k)
+            {
+                index[axis(k)] = 0;
+                ++index[axis(k - 1)];
+            }
+        }
+    }
+
+    /*****************
+     * zview_wrapper *
+     *****************/
+
+    template <class T>
+    inline zview_wrapper<T>::zview_wrapper(const holder_type& base,
+                                           shape_type&& shape,
+                                           strides_type&& strides,
+                                           std::size_t offset,
+                                           layout_type layout)
+        : base_type()
+        , p_base(base)
+        , m_view(static_cast<const ztyped_array<T>&>(*base).get_array(),
+                 std::move(shape), std::move(strides), offset, layout)
+        , m_cache()
+    {
+    }
+
+    // The copy of the viewed elements is not copied,
+    // the clone computes its own on demand.
+    template <class T>
+    inline zview_wrapper<T>::zview_wrapper(const zview_wrapper& rhs)
+        : base_type(rhs)
+        , p_base(rhs.p_base)
+        , m_view(rhs.m_view)
+        , m_cache()
+    {
+    }
+
+    template <class T>
+    inline xarray<T>& zview_wrapper<T>::get_array()
+    {
+        compute_cache();
+        return m_cache;
+    }
+
+    template <class T>
+    inline const xarray<T>& zview_wrapper<T>::get_array() const
+    {
+        compute_cache();
+        return m_cache;
+    }
+
+    template <class T>
+    inline auto zview_wrapper<T>::get_view() const noexcept -> const view_type&
+    {
+        return m_view;
+    }
+
+    template <class T>
+    inline auto zview_wrapper<T>::clone() const -> self_type*
+    {
+        return new self_type(*this);
+    }
+
+    template <class T>
+    inline bool zview_wrapper<T>::owns_data() const noexcept
+    {
+        return false;
+    }
+
+    template <class T>
+    inline auto zview_wrapper<T>::shape() const -> const shape_type&
+    {
+        return m_view.shape();
+    }
+
+    template <class T>
+    inline void zview_wrapper<T>::resize(const shape_type&)
+    {
+        XTENSOR_THROW(std::runtime_error, "cannot resize a zarray view");
+    }
+
+    template <class T>
+    inline void zview_wrapper<T>::get_block(zarray_impl& block, std::size_t offset, std::size_t size) const
+    {
+        xarray<T>& dst = static_cast<ztyped_array<T>&>(block).get_array();
+        dst.resize({size});
+        auto first = m_view.template cbegin<XTENSOR_DEFAULT_LAYOUT>();
+        first += static_cast<std::ptrdiff_t>(offset);
+        std::copy_n(first, size, dst.data());
+    }
+
+    // Writes the block through the view into the buffer of the viewed
+    // array, which must belong to a zarray: like for the containers, an
+    // external array or a chunked array copy is never written to.
+    template <class T>
+    inline void zview_wrapper<T>::set_block(const zarray_impl& block, std::size_t offset)
+    {
+        if (!p_base->owns_data() || p_base->is_chunked())
+        {
+            XTENSOR_THROW(std::runtime_error, "cannot assign to a view on an external or chunked zarray");
+        }
+        using mutable_view_type = xstrided_view<xarray<T>&, shape_type>;
+        xarray<T>& a = const_cast<xarray<T>&>(m_view.expression());
+        mutable_view_type dst(a,
+                              shape_type(m_view.shape()),
+                              strides_type(m_view.strides()),
+                              m_view.data_offset(),
+                              m_view.layout());
+        const xarray<T>& src = static_cast<const ztyped_array<T>&>(block).get_array();
+        auto first = dst.template begin<XTENSOR_DEFAULT_LAYOUT>();
+        first += static_cast<std::ptrdiff_t>(offset);
+        std::copy(src.data(), src.data() + src.size(), first);
+    }
+
+    template <class T>
+    inline void zview_wrapper<T>::get_broadcast_block(zarray_impl& block,
+                                                      const shape_type& shape,
+                                                      std::size_t offset,
+                                                      std::size_t size) const
+    {
+        xarray<T>& dst = static_cast<ztyped_array<T>&>(block).get_array();
+        dst.resize({size});
+        auto broadcasted = xt::broadcast(m_view, shape);
+        auto first = broadcasted.template cbegin<XTENSOR_DEFAULT_LAYOUT>();
+        first += static_cast<std::ptrdiff_t>(offset);
+        std::copy_n(first, size, dst.data());
+    }
+
+    // The view reads the buffer of the viewed array in place
+    template <class T>
+    inline void zview_wrapper<T>::materialize() const
+    {
+    }
+
+    template <class T>
+    inline bool zview_wrapper<T>::is_view() const noexcept
+    {
+        return true;
+    }
+
+    // Slicing a view composes the slices with the strides of the view,
+    // the new view shares the buffer of the viewed array.
+    template <class T>
+    inline zarray_impl* zview_wrapper<T>::strided_view(const holder_type&,
+                                                       const xstrided_slice_vector& slices) const
+    {
+        detail::strided_view_args<detail::no_adj_strides_policy> args;
+        args.fill_args(m_view.shape(), m_view.strides(), m_view.data_offset(), m_view.layout(), slices);
+        return new self_type(p_base,
+                             std::move(args.new_shape),
+                             std::move(args.new_strides),
+                             args.new_offset,
+                             args.new_layout);
+    }
+
+    // Concurrent calls to get_array build the copy once.
+    template <class T>
+    inline void zview_wrapper<T>::compute_cache() const
+    {
+        std::call_once(m_cache_flag, [this]() { m_cache = m_view; });
+    }
+
     /******************
      * zarray builder *
      ******************/
@@ -248,9 +915,12 @@ namespace xt
         struct zwrapper_builder
         {
             using closure_type = xtl::closure_type_t<E>;
+            using expression_wrapper_type = std::conditional_t<chunk_helper<std::decay_t<E>>::is_chunked::value,
+                                                               zchunked_wrapper<closure_type>,
+                                                               zexpression_wrapper<closure_type>>;
             using wrapper_type = std::conditional_t<is_xarray<std::decay_t<E>>::value,
                                                     zarray_wrapper<closure_type>,
-                                                    zexpression_wrapper<closure_type>>;
+                                                    expression_wrapper_type>;
 
             template <class OE>
             static wrapper_type* run(OE&& e)
@@ -20,12 +20,95 @@ namespace xt
     {
     public:
 
+        // Both assignments below follow the same rule: the result is
+        // written into the container the zarray refers to when it can hold
+        // it, i.e. when it has the type and the shape of the result and is
+        // not a view, and the expression reads no view that could alias it.
+        // The container must also belong to the zarray, unless it accepts
+        // the result explicitly (that is how a tree is evaluated into a
+        // chunked array with bounded memory): an external xarray wrapped
+        // by reference is never written to. Otherwise, the implementation
+        // of the zarray is replaced with a new buffer holding the result,
+        // and the former container is left untouched.
+        // When the zarray is a view, the result is written through it into
+        // the viewed array instead, like with xt::strided_view.
+
+        // zarray(e) and noalias(z) = e
         template <class E1, class E2>
         static void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
         {
-            std::unique_ptr<zarray_impl> res_impl = e2.derived_cast().allocate_result();
-            e2.derived_cast().assign_to(*res_impl);
-            e1.derived_cast() = std::move(res_impl);
+            E1& de1 = e1.derived_cast();
+            const E2& de2 = e2.derived_cast();
+            // Planning pass: the broadcast shape of the whole tree is
+            // computed and validated once, before anything is allocated;
+            // the nodes of the tree reuse the shapes cached here. The
+            // result buffer comes from the pool, or is the temporary
+            // of an operand.
+            de2.shape();
+            if (de1.has_implementation() && de1.get_implementation().is_view())
+            {
+                assign_to_view(de1.get_implementation(), de2);
+            }
+            else if (de1.has_implementation() && can_assign_in_place(de1.get_implementation(), de2))
+            {
+                de2.assign_to(de1.get_implementation());
+            }
+            else
+            {
+                de1 = de2.evaluate();
+            }
+        }
+
+        // e1 += e2 is computed as e1 = e1 + e2: since the functors are
+        // element-wise, the result is written directly into the container
+        // of e1 under the rule above, which avoids its allocation.
+        template <class E1, class E2>
+        static void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
+        {
+            const E2& de2 = e2.derived_cast();
+            zarray_impl& impl = e1.derived_cast().get_implementation();
+            de2.shape();
+            if (impl.is_view())
+            {
+                assign_to_view(impl, de2);
+            }
+            else if (can_assign_in_place(impl, de2))
+            {
+                de2.assign_to(impl);
+            }
+            else
+            {
+                e1.derived_cast() = de2.evaluate();
+            }
+        }
+
+    private:
+
+        // The result is evaluated into a temporary first, since the
+        // expression may read the viewed array through another view.
+        template <class E>
+        static void assign_to_view(zarray_impl& view, const E& e)
+        {
+            auto tmp = e.evaluate();
+            if (tmp->get_class_index() != view.get_class_index())
+            {
+                XTENSOR_THROW(std::runtime_error, "cannot assign a result of another value type to a zarray view");
+            }
+            if (tmp->shape() != view.shape())
+            {
+                XTENSOR_THROW(std::runtime_error, "cannot assign a result of another shape to a zarray view");
+            }
+            view.set_block(*tmp, 0);
+        }
+
+        template <class E>
+        static bool can_assign_in_place(const zarray_impl& impl, const E& e)
+        {
+            return !impl.is_view()
+                && (impl.owns_data() || impl.accepts_in_place_result())
+                && !e.has_view_operand()
+                && impl.get_class_index() == e.get_result_type_index()
+                && impl.shape() == e.shape();
         }
     };
 
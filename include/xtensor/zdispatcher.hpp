@@ -10,6 +10,10 @@
 #ifndef XTENSOR_ZDISPATCHER_HPP
 #define XTENSOR_ZDISPATCHER_HPP
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include <xtl/xmultimethods.hpp>
 
 #include "zmath.hpp"
@@ -113,6 +117,54 @@ namespace xt
         zrun_dispatcher m_run_dispatcher;
     };
 
+    /***********************
+     * zreducer_dispatcher *
+     ***********************/
+
+    // Reducer dispatchers are used for reductions. They
+    // dispatch on the argument only (its value type determines
+    // the result type) and forward the runtime axes to the
+    // functor, which the xtl multimethods cannot do.
+
+    template <class F>
+    class zreducer_dispatcher
+    {
+    public:
+
+        using axes_type = typename F::axes_type;
+
+        template <class T, class R>
+        static void insert();
+
+        static void init();
+        static void dispatch(const zarray_impl& z1, zarray_impl& res, const axes_type& axes);
+        static size_t get_type_index(const zarray_impl& z1);
+
+    private:
+
+        static zreducer_dispatcher& instance();
+
+        zreducer_dispatcher();
+        ~zreducer_dispatcher() = default;
+
+        template <class T, class R>
+        void insert_impl();
+
+        template <class T, class R>
+        static void run(const zarray_impl& z1, zarray_impl& res, const axes_type& axes);
+
+        template <class T>
+        static size_t index(const zarray_impl& z1);
+
+        using run_function = void (*)(const zarray_impl&, zarray_impl&, const axes_type&);
+        using index_function = size_t (*)(const zarray_impl&);
+
+        size_t get_slot(const zarray_impl& z1) const;
+
+        std::vector<run_function> m_run_dispatcher;
+        std::vector<index_function> m_type_dispatcher;
+    };
+
     /***************
      * zdispatcher *
      ***************/
@@ -163,6 +215,40 @@ namespace xt
         std::vector<std::unique_ptr<zarray_impl>> m_register;
     };
 
+    /********************
+     * zarray_impl_pool *
+     ********************/
+
+    // Pool of the buffers used for intermediate results of
+    // zfunction trees. Released buffers are kept per value
+    // type and handed back to results of the same size, so
+    // that repeated evaluations of expressions with the same
+    // shapes do not hit the allocator. Each thread has its
+    // own pool, which holds at most XTENSOR_ZARRAY_POOL_BYTES.
+
+    class zarray_impl_pool
+    {
+    public:
+
+        using buffer_type = std::unique_ptr<zarray_impl>;
+
+        static buffer_type acquire(size_t index, size_t size);
+        static void release(buffer_type buffer);
+        static void clear();
+        static size_t pooled_bytes();
+
+    private:
+
+        static zarray_impl_pool& instance();
+        static size_t buffer_bytes(const zarray_impl& buffer);
+
+        zarray_impl_pool() = default;
+        ~zarray_impl_pool() = default;
+
+        std::vector<std::vector<buffer_type>> m_pool;
+        size_t m_bytes = 0;
+    };
+
     /****************
      * init_zsystem *
      ****************/
@@ -283,6 +369,96 @@ namespace xt
         m_type_dispatcher.template insert<arg_type1, arg_type1>(&zfunctor_type::template index<T1, T2>);
     }
 
+    /**************************************
+     * zreducer_dispatcher implementation *
+     **************************************/
+
+    template <class F>
+    template <class T, class R>
+    inline void zreducer_dispatcher<F>::insert()
+    {
+        instance().template insert_impl<T, R>();
+    }
+
+    template <class F>
+    inline void zreducer_dispatcher<F>::init()
+    {
+        instance();
+    }
+
+    template <class F>
+    inline void zreducer_dispatcher<F>::dispatch(const zarray_impl& z1, zarray_impl& res, const axes_type& axes)
+    {
+        zreducer_dispatcher& inst = instance();
+        inst.m_run_dispatcher[inst.get_slot(z1)](z1, res, axes);
+    }
+
+    template <class F>
+    inline size_t zreducer_dispatcher<F>::get_type_index(const zarray_impl& z1)
+    {
+        zreducer_dispatcher& inst = instance();
+        return inst.m_type_dispatcher[inst.get_slot(z1)](z1);
+    }
+
+    template <class F>
+    inline zreducer_dispatcher<F>& zreducer_dispatcher<F>::instance()
+    {
+        static zreducer_dispatcher<F> inst;
+        return inst;
+    }
+
+    template <class F>
+    inline zreducer_dispatcher<F>::zreducer_dispatcher()
+    {
+        insert_impl<float, typename F::template result_type<float>>();
+        insert_impl<double, typename F::template result_type<double>>();
+    }
+
+    template <class F>
+    template <class T, class R>
+    inline void zreducer_dispatcher<F>::insert_impl()
+    {
+        // Registering the types assigns their class indices
+        // and allows to allocate results of type R.
+        zarray_impl_register::insert<T>();
+        zarray_impl_register::insert<R>();
+        size_t idx = ztyped_array<T>::get_class_static_index();
+        if (m_run_dispatcher.size() <= idx)
+        {
+            m_run_dispatcher.resize(idx + 1u, nullptr);
+            m_type_dispatcher.resize(idx + 1u, nullptr);
+        }
+        m_run_dispatcher[idx] = &zreducer_dispatcher::template run<T, R>;
+        m_type_dispatcher[idx] = &zreducer_dispatcher::template index<T>;
+    }
+
+    template <class F>
+    template <class T, class R>
+    inline void zreducer_dispatcher<F>::run(const zarray_impl& z1, zarray_impl& res, const axes_type& axes)
+    {
+        F::template run<T, R>(static_cast<const ztyped_array<T>&>(z1),
+                              static_cast<ztyped_array<R>&>(res),
+                              axes);
+    }
+
+    template <class F>
+    template <class T>
+    inline size_t zreducer_dispatcher<F>::index(const zarray_impl& z1)
+    {
+        return F::index(static_cast<const ztyped_array<T>&>(z1));
+    }
+
+    template <class F>
+    inline size_t zreducer_dispatcher<F>::get_slot(const zarray_impl& z1) const
+    {
+        size_t idx = z1.get_class_index();
+        if (idx >= m_run_dispatcher.size() || m_run_dispatcher[idx] == nullptr)
+        {
+            XTENSOR_THROW(std::runtime_error, "No reducer registered for this value type");
+        }
+        return idx;
+    }
+
     /***************************************
      * zarray_impl_register implementation *
      ***************************************/
@@ -333,6 +509,94 @@ namespace xt
         m_register[idx] = std::unique_ptr<zarray_impl>(detail::build_zarray(std::move(xarray<T>())));
     }
 
+    /***********************************
+     * zarray_impl_pool implementation *
+     ***********************************/
+
+    /**
+     * Returns a buffer holding values of the type registered at \c index.
+     * The buffer must be resized by the caller; it is taken from the pool
+     * when the pool has a buffer of \c size elements, so that this resize
+     * does not allocate. Otherwise, a new empty buffer is returned and the
+     * buffers of the pool are kept for the results of their size.
+     */
+    inline auto zarray_impl_pool::acquire(size_t index, size_t size) -> buffer_type
+    {
+        zarray_impl_pool& inst = instance();
+        if (index < inst.m_pool.size())
+        {
+            std::vector<buffer_type>& buffers = inst.m_pool[index];
+            auto it = std::find_if(buffers.begin(), buffers.end(), [size](const buffer_type& b)
+            {
+                return compute_size(b->shape()) == size;
+            });
+            if (it != buffers.end())
+            {
+                buffer_type res = std::move(*it);
+                buffers.erase(it);
+                inst.m_bytes -= buffer_bytes(*res);
+                return res;
+            }
+        }
+        return buffer_type(zarray_impl_register::get(index).clone());
+    }
+
+    /**
+     * Gives back a buffer previously acquired. At most XTENSOR_ZARRAY_POOL_SIZE
+     * buffers are kept per value type, and at most XTENSOR_ZARRAY_POOL_BYTES
+     * bytes are kept by the pool of the calling thread: the buffers that do
+     * not fit, like those larger than that budget, are destroyed.
+     */
+    inline void zarray_impl_pool::release(buffer_type buffer)
+    {
+        zarray_impl_pool& inst = instance();
+        size_t bytes = buffer_bytes(*buffer);
+        if (bytes > XTENSOR_ZARRAY_POOL_BYTES - inst.m_bytes)
+        {
+            return;
+        }
+        size_t index = buffer->get_class_index();
+        if (inst.m_pool.size() <= index)
+        {
+            inst.m_pool.resize(index + 1u);
+        }
+        std::vector<buffer_type>& buffers = inst.m_pool[index];
+        if (buffers.size() < XTENSOR_ZARRAY_POOL_SIZE)
+        {
+            buffers.push_back(std::move(buffer));
+            inst.m_bytes += bytes;
+        }
+    }
+
+    /**
+     * Destroys all the buffers of the pool of the calling thread.
+     */
+    inline void zarray_impl_pool::clear()
+    {
+        zarray_impl_pool& inst = instance();
+        inst.m_pool.clear();
+        inst.m_bytes = 0;
+    }
+
+    /**
+     * Returns the number of bytes held by the pool of the calling thread.
+     */
+    inline size_t zarray_impl_pool::pooled_bytes()
+    {
+        return instance().m_bytes;
+    }
+
+    inline size_t zarray_impl_pool::buffer_bytes(const zarray_impl& buffer)
+    {
+        return compute_size(buffer.shape()) * buffer.value_size();
+    }
+
+    inline zarray_impl_pool& zarray_impl_pool::instance()
+    {
+        thread_local static zarray_impl_pool inst;
+        return inst;
+    }
+
     /*******************************
      * init_zsystem implementation *
      *******************************/
@@ -416,10 +680,23 @@ namespace xt
         }
     }
 
+    namespace detail
+    {
+        inline void init_zreducers()
+        {
+            zreducer_dispatcher<zsum>::init();
+            zreducer_dispatcher<zprod>::init();
+            zreducer_dispatcher<zmean>::init();
+            zreducer_dispatcher<zamax>::init();
+            zreducer_dispatcher<zamin>::init();
+        }
+    }
+
     inline int init_zsystem()
     {
         detail::init_zdispatchers();
         math::init_zdispatchers();
+        detail::init_zreducers();
         return 0;
     }
 }
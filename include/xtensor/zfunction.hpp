@@ -10,13 +10,66 @@
 #ifndef XTENSOR_ZFUNCTION_HPP
 #define XTENSOR_ZFUNCTION_HPP
 
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <memory>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "zdispatcher.hpp"
 
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#endif
+
 namespace xt
 {
+    namespace detail
+    {
+        /*****************
+         * zblock_buffers *
+         *****************/
+
+        // Block buffers of the nodes of a zfunction tree, stored in
+        // depth-first order so that each block evaluation can consume
+        // them with a simple cursor. The buffers are taken from the
+        // zarray_impl_pool and given back on destruction. The offsets
+        // of the blocks refer to the shape of the result, to which the
+        // leaves of the tree are broadcast.
+        class zblock_buffers
+        {
+        public:
+
+            using buffer_type = std::unique_ptr<zarray_impl>;
+            using shape_type = zarray_impl::shape_type;
+
+            zblock_buffers(std::size_t block_size, const shape_type& shape);
+            ~zblock_buffers();
+
+            zblock_buffers(const zblock_buffers&) = delete;
+            zblock_buffers& operator=(const zblock_buffers&) = delete;
+
+            zarray_impl& acquire(std::size_t index);
+            zarray_impl& next();
+            void rewind() noexcept;
+
+            const shape_type& shape() const noexcept;
+
+        private:
+
+            std::vector<buffer_type> m_buffers;
+            std::size_t m_block_size;
+            std::size_t m_cursor;
+            const shape_type& m_shape;
+        };
+    }
+
+    /*************
+     * zfunction *
+     *************/
+
     template <class F, class... CT>
     class zfunction : public xexpression<zfunction<F, CT...>>
     {
@@ -27,25 +80,69 @@ namespace xt
         using self_type = zfunction<F, CT...>;
         using tuple_type = std::tuple<CT...>;
         using functor_type = F;
+        using shape_type = zarray_impl::shape_type;
+        using size_type = std::size_t;
+        using buffer_type = std::unique_ptr<zarray_impl>;
 
         template <class Func, class... CTA, class U = std::enable_if_t<!std::is_base_of<std::decay_t<Func>, self_type>::value>>
         zfunction(Func&& f, CTA&&... e) noexcept;
 
+        size_type dimension() const;
+        const shape_type& shape() const;
+        bool is_trivial_broadcast() const;
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
         std::unique_ptr<zarray_impl> allocate_result() const;
         std::size_t get_result_type_index() const;
         zarray_impl& assign_to(zarray_impl& res) const;
+        buffer_type evaluate() const;
+
+        bool has_view_operand() const;
+        bool has_chunked_operand() const;
+        void materialize_operands() const;
+        zarray* get_reusable_operand();
+
+        void allocate_blocks(detail::zblock_buffers& buffers) const;
+        zarray_impl& assign_block_to(zarray_impl& res,
+                                     detail::zblock_buffers& buffers,
+                                     std::size_t offset,
+                                     std::size_t size) const;
 
     private:
 
         using dispatcher_type = zdispatcher_t<F, sizeof...(CT)>;
+        using temporaries_type = std::array<buffer_type, sizeof...(CT)>;
+        using arguments_type = std::array<const zarray_impl*, sizeof...(CT)>;
+
+        size_type compute_dimension() const;
+        void compute_cached_shape() const;
+        bool prepare_concurrent_evaluation(bool chunked_result) const;
 
         template <std::size_t... I>
         std::size_t get_result_type_index_impl(std::index_sequence<I...>) const;
 
+        arguments_type evaluate_arguments(temporaries_type& tmp, bool concurrent) const;
+
+        template <std::size_t... I>
+        buffer_type assign_to_impl(std::index_sequence<I...>, zarray_impl* res, bool concurrent) const;
+
+        zarray_impl& assign_blocks_to(zarray_impl& res) const;
+        void assign_block_range(zarray_impl& res,
+                                std::size_t first_block,
+                                std::size_t last_block,
+                                std::size_t block_size) const;
+
         template <std::size_t... I>
-        zarray_impl& assign_to_impl(std::index_sequence<I...>, zarray_impl& res) const;
+        zarray_impl& assign_block_impl(std::index_sequence<I...>,
+                                       zarray_impl& res,
+                                       detail::zblock_buffers& buffers,
+                                       std::size_t offset,
+                                       std::size_t size) const;
 
         tuple_type m_e;
+        mutable detail::xfunction_cache_impl<shape_type, std::false_type> m_cache;
     };
 
     namespace detail
@@ -57,32 +154,202 @@ namespace xt
         };
     }
 
+    /*********************************
+     * zblock_buffers implementation *
+     *********************************/
+
+    namespace detail
+    {
+        inline zblock_buffers::zblock_buffers(std::size_t block_size, const shape_type& shape)
+            : m_buffers(), m_block_size(block_size), m_cursor(0), m_shape(shape)
+        {
+        }
+
+        inline zblock_buffers::~zblock_buffers()
+        {
+            for (auto& buffer : m_buffers)
+            {
+                zarray_impl_pool::release(std::move(buffer));
+            }
+        }
+
+        inline zarray_impl& zblock_buffers::acquire(std::size_t index)
+        {
+            m_buffers.push_back(zarray_impl_pool::acquire(index, m_block_size));
+            return *m_buffers.back();
+        }
+
+        inline zarray_impl& zblock_buffers::next()
+        {
+            return *m_buffers[m_cursor++];
+        }
+
+        inline void zblock_buffers::rewind() noexcept
+        {
+            m_cursor = 0;
+        }
+
+        inline auto zblock_buffers::shape() const noexcept -> const shape_type&
+        {
+            return m_shape;
+        }
+    }
+
     /****************************
      * zfunction implementation *
      ****************************/
 
     class zarray;
-    
+
     namespace detail
     {
+        // Returns the first temporary that can hold a result of the
+        // given type and shape, or a buffer from the pool otherwise.
+        template <std::size_t N>
+        inline std::unique_ptr<zarray_impl> zreuse_temporary(std::array<std::unique_ptr<zarray_impl>, N>& tmp,
+                                                            std::size_t index,
+                                                            const zarray_impl::shape_type& shape)
+        {
+            for (auto& t : tmp)
+            {
+                if (t != nullptr && t->get_class_index() == index && t->shape() == shape)
+                {
+                    return std::move(t);
+                }
+            }
+            std::unique_ptr<zarray_impl> res = zarray_impl_pool::acquire(index, compute_size(shape));
+            res->resize(shape);
+            return res;
+        }
+
+        // Calls f(i) for each i in [0, n), concurrently if concurrent is
+        // true and xtensor is built with TBB or OpenMP. An exception thrown
+        // by f is rethrown on the calling thread.
+        template <class F>
+        inline void zparallel_for(std::size_t n, bool concurrent, F&& f)
+        {
+#if defined(XTENSOR_USE_TBB)
+            if (concurrent)
+            {
+                tbb::parallel_for(std::size_t(0), n, f);
+                return;
+            }
+#elif defined(XTENSOR_USE_OPENMP)
+            if (concurrent)
+            {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+                #pragma omp parallel for
+                for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); ++i)
+                {
+                    f(static_cast<std::size_t>(i));
+                }
+#else
+                // An exception escaping the parallel region would call std::terminate
+                std::exception_ptr error;
+                #pragma omp parallel for
+                for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); ++i)
+                {
+                    try
+                    {
+                        f(static_cast<std::size_t>(i));
+                    }
+                    catch (...)
+                    {
+                        #pragma omp critical(xtensor_zparallel_for)
+                        {
+                            if (error == nullptr)
+                            {
+                                error = std::current_exception();
+                            }
+                        }
+                    }
+                }
+                if (error != nullptr)
+                {
+                    std::rethrow_exception(error);
+                }
+#endif
+                return;
+            }
+#else
+            (void)concurrent;
+#endif
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                f(i);
+            }
+        }
 
         template <class E>
         struct zfunction_argument
         {
+            using shape_type = zarray_impl::shape_type;
+            using buffer_type = std::unique_ptr<zarray_impl>;
+
             static std::size_t get_index(const E& e)
             {
                 return e.get_result_type_index();
             }
 
-            static const zarray_impl& get_array_impl(const E& e, zarray_impl& res)
+            static std::size_t get_dimension(const E& e)
+            {
+                return e.dimension();
+            }
+
+            static bool broadcast_shape(const E& e, shape_type& shape)
+            {
+                bool trivial = xt::broadcast_shape(e.shape(), shape);
+                return e.is_trivial_broadcast() && trivial;
+            }
+
+            static const zarray_impl& get_array_impl(const E& e, buffer_type& tmp)
+            {
+                tmp = e.evaluate();
+                return *tmp;
+            }
+
+            static bool has_view_operand(const E& e)
+            {
+                return e.has_view_operand();
+            }
+
+            static bool has_chunked_operand(const E& e)
+            {
+                return e.has_chunked_operand();
+            }
+
+            static void materialize(const E& e)
+            {
+                e.materialize_operands();
+            }
+
+            static zarray* get_reusable_operand(const E&, std::size_t, const shape_type&)
             {
-                return e.assign_to(res);
+                return nullptr;
+            }
+
+            static void allocate_blocks(const E& e, zblock_buffers& buffers)
+            {
+                buffers.acquire(get_index(e));
+                e.allocate_blocks(buffers);
+            }
+
+            static const zarray_impl& get_block_impl(const E& e,
+                                                     zblock_buffers& buffers,
+                                                     std::size_t offset,
+                                                     std::size_t size)
+            {
+                zarray_impl& block = buffers.next();
+                return e.assign_block_to(block, buffers, offset, size);
             }
         };
 
         template <>
         struct zfunction_argument<zarray>
         {
+            using shape_type = zarray_impl::shape_type;
+            using buffer_type = std::unique_ptr<zarray_impl>;
+
             template <class E>
             static std::size_t get_index(const E& e)
             {
@@ -90,10 +357,73 @@ namespace xt
             }
 
             template <class E>
-            static const zarray_impl& get_array_impl(const E& e, zarray_impl&)
+            static std::size_t get_dimension(const E& e)
+            {
+                return e.get_implementation().shape().size();
+            }
+
+            template <class E>
+            static bool broadcast_shape(const E& e, shape_type& shape)
+            {
+                return xt::broadcast_shape(e.get_implementation().shape(), shape);
+            }
+
+            template <class E>
+            static const zarray_impl& get_array_impl(const E& e, buffer_type&)
             {
                 return e.get_implementation();
             }
+
+            template <class E>
+            static bool has_view_operand(const E& e)
+            {
+                return e.get_implementation().is_view();
+            }
+
+            template <class E>
+            static bool has_chunked_operand(const E& e)
+            {
+                return e.get_implementation().is_chunked();
+            }
+
+            template <class E>
+            static void materialize(const E& e)
+            {
+                e.get_implementation().materialize();
+            }
+
+            // Operands held by reference belong to the caller
+            template <class E>
+            static zarray* get_reusable_operand(const E&, std::size_t, const shape_type&)
+            {
+                return nullptr;
+            }
+
+            // Operands held by value are rvalues moved into the expression
+            template <class E>
+            static zarray* get_reusable_operand(E& e, std::size_t index, const shape_type& shape)
+            {
+                const zarray_impl& impl = e.get_implementation();
+                bool reusable = impl.owns_data() && impl.get_class_index() == index && impl.shape() == shape;
+                return reusable ? &e : nullptr;
+            }
+
+            template <class E>
+            static void allocate_blocks(const E& e, zblock_buffers& buffers)
+            {
+                buffers.acquire(get_index(e));
+            }
+
+            template <class E>
+            static const zarray_impl& get_block_impl(const E& e,
+                                                     zblock_buffers& buffers,
+                                                     std::size_t offset,
+                                                     std::size_t size)
+            {
+                zarray_impl& block = buffers.next();
+                e.get_implementation().get_broadcast_block(block, buffers.shape(), offset, size);
+                return block;
+            }
         };
 
         template <class E>
@@ -103,9 +433,60 @@ namespace xt
         }
 
         template <class E>
-        inline const zarray_impl& get_array_impl(const E& e, zarray_impl& z)
+        inline std::size_t get_dimension(const E& e)
+        {
+            return zfunction_argument<E>::get_dimension(e);
+        }
+
+        template <class E>
+        inline bool broadcast_shape(const E& e, zarray_impl::shape_type& shape)
+        {
+            return zfunction_argument<E>::broadcast_shape(e, shape);
+        }
+
+        template <class E>
+        inline const zarray_impl& get_array_impl(const E& e, std::unique_ptr<zarray_impl>& tmp)
         {
-            return zfunction_argument<E>::get_array_impl(e, z);
+            return zfunction_argument<E>::get_array_impl(e, tmp);
+        }
+
+        template <class E>
+        inline bool has_view_operand(const E& e)
+        {
+            return zfunction_argument<E>::has_view_operand(e);
+        }
+
+        template <class E>
+        inline bool has_chunked_operand(const E& e)
+        {
+            return zfunction_argument<E>::has_chunked_operand(e);
+        }
+
+        template <class E>
+        inline void materialize(const E& e)
+        {
+            zfunction_argument<E>::materialize(e);
+        }
+
+        template <class E>
+        inline zarray* get_reusable_operand(E& e, std::size_t index, const zarray_impl::shape_type& shape)
+        {
+            return zfunction_argument<std::decay_t<E>>::get_reusable_operand(e, index, shape);
+        }
+
+        template <class E>
+        inline void allocate_blocks(const E& e, zblock_buffers& buffers)
+        {
+            zfunction_argument<E>::allocate_blocks(e, buffers);
+        }
+
+        template <class E>
+        inline const zarray_impl& get_block_impl(const E& e,
+                                                 zblock_buffers& buffers,
+                                                 std::size_t offset,
+                                                 std::size_t size)
+        {
+            return zfunction_argument<E>::get_block_impl(e, buffers, offset, size);
         }
     }
 
@@ -113,7 +494,68 @@ namespace xt
     template <class Func, class... CTA, class U>
     inline zfunction<F, CT...>::zfunction(Func&&, CTA&&... e) noexcept
         : m_e(std::forward<CTA>(e)...)
+        , m_cache()
+    {
+    }
+
+    /**
+     * Returns the number of dimensions of the function.
+     */
+    template <class F, class... CT>
+    inline auto zfunction<F, CT...>::dimension() const -> size_type
+    {
+        return m_cache.is_initialized ? m_cache.shape.size() : compute_dimension();
+    }
+
+    /**
+     * Returns the shape of the function. The broadcast shape of the
+     * whole tree is computed and validated on the first call only;
+     * each node of the tree caches its own shape.
+     */
+    template <class F, class... CT>
+    inline auto zfunction<F, CT...>::shape() const -> const shape_type&
+    {
+        if (!m_cache.is_initialized)
+        {
+            compute_cached_shape();
+        }
+        return m_cache.shape;
+    }
+
+    /**
+     * Returns true if all the leaves of the function have the same shape.
+     */
+    template <class F, class... CT>
+    inline bool zfunction<F, CT...>::is_trivial_broadcast() const
     {
+        if (!m_cache.is_initialized)
+        {
+            compute_cached_shape();
+        }
+        return m_cache.is_trivial;
+    }
+
+    /**
+     * Broadcast the shape of the function to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache boolean for reusing a previously computed shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class F, class... CT>
+    template <class S>
+    inline bool zfunction<F, CT...>::broadcast_shape(S& shape, bool reuse_cache) const
+    {
+        if (m_cache.is_initialized && reuse_cache)
+        {
+            std::copy(m_cache.shape.cbegin(), m_cache.shape.cend(), shape.begin());
+            return m_cache.is_trivial;
+        }
+        else
+        {
+            // detail::broadcast_shape must be evaluated even if b is false
+            auto func = [&shape](bool b, const auto& e) { return detail::broadcast_shape(e, shape) && b; };
+            return accumulate(func, true, m_e);
+        }
     }
 
     template <class F, class... CT>
@@ -129,10 +571,160 @@ namespace xt
         return get_result_type_index_impl(std::make_index_sequence<sizeof...(CT)>());
     }
 
+    /**
+     * Evaluates the function into \c res, which is resized to the shape
+     * of the function if needed. When all the leaves of the tree have the
+     * same shape, the whole tree is evaluated in a single pass, block by
+     * block, so that the intermediate results stay in cache; otherwise,
+     * each node is evaluated into its own temporary, preallocated with
+     * the shape computed by the planning pass. When xtensor is built with
+     * TBB or OpenMP, the blocks are evaluated concurrently in the first
+     * case, and the independent subtrees are in the second case, if the
+     * result has at least XTENSOR_ZARRAY_PARALLEL_THRESHOLD elements and
+     * neither the result nor the leaves are chunked arrays.
+     * A chunked result is always evaluated block by block, the leaves
+     * being broadcast block by block too, so that it is never held in
+     * memory as a whole.
+     */
     template <class F, class... CT>
     inline zarray_impl& zfunction<F, CT...>::assign_to(zarray_impl& res) const
     {
-        return assign_to_impl(std::make_index_sequence<sizeof...(CT)>(), res);
+        res.resize(shape());
+        if (is_trivial_broadcast() || res.is_chunked())
+        {
+            return assign_blocks_to(res);
+        }
+        bool concurrent = prepare_concurrent_evaluation(false);
+        assign_to_impl(std::make_index_sequence<sizeof...(CT)>(), &res, concurrent);
+        return res;
+    }
+
+    /**
+     * Evaluates the function into a new buffer. The buffer is taken from
+     * the zarray_impl_pool, or is the temporary result of an operand
+     * when it has the type and the shape of the result.
+     */
+    template <class F, class... CT>
+    inline auto zfunction<F, CT...>::evaluate() const -> buffer_type
+    {
+        if (is_trivial_broadcast())
+        {
+            buffer_type res = zarray_impl_pool::acquire(get_result_type_index(), compute_size(shape()));
+            res->resize(shape());
+            assign_blocks_to(*res);
+            return res;
+        }
+        bool concurrent = prepare_concurrent_evaluation(false);
+        return assign_to_impl(std::make_index_sequence<sizeof...(CT)>(), nullptr, concurrent);
+    }
+
+    /**
+     * Returns true if a leaf of the function is a view on the buffer of
+     * another zarray. Such a view may alias any array of the tree, so the
+     * function is never evaluated in place into one of its operands.
+     */
+    template <class F, class... CT>
+    inline bool zfunction<F, CT...>::has_view_operand() const
+    {
+        auto func = [](bool b, const auto& e) { return b || detail::has_view_operand(e); };
+        return accumulate(func, false, m_e);
+    }
+
+    /**
+     * Returns true if a leaf of the function is a chunked array, whose
+     * chunks may be stored on disk and cannot be read concurrently.
+     */
+    template <class F, class... CT>
+    inline bool zfunction<F, CT...>::has_chunked_operand() const
+    {
+        auto func = [](bool b, const auto& e) { return b || detail::has_chunked_operand(e); };
+        return accumulate(func, false, m_e);
+    }
+
+    /**
+     * Computes the lazily evaluated content of the leaves of the function,
+     * so that they can be read concurrently.
+     */
+    template <class F, class... CT>
+    inline void zfunction<F, CT...>::materialize_operands() const
+    {
+        for_each([](const auto& e) { detail::materialize(e); }, m_e);
+    }
+
+    /**
+     * Returns an operand held by value (i.e. a zarray moved into the
+     * expression) that owns its data and has the type and the shape
+     * of the result, or nullptr if there is none. The function can be
+     * evaluated in place into that operand since it is element-wise.
+     */
+    template <class F, class... CT>
+    inline zarray* zfunction<F, CT...>::get_reusable_operand()
+    {
+        if (has_view_operand())
+        {
+            return nullptr;
+        }
+        std::size_t index = get_result_type_index();
+        const shape_type& s = shape();
+        zarray* res = nullptr;
+        for_each([&res, index, &s](auto& e)
+        {
+            if (res == nullptr)
+            {
+                res = detail::get_reusable_operand(e, index, s);
+            }
+        }, m_e);
+        return res;
+    }
+
+    template <class F, class... CT>
+    inline void zfunction<F, CT...>::allocate_blocks(detail::zblock_buffers& buffers) const
+    {
+        for_each([&buffers](const auto& e) { detail::allocate_blocks(e, buffers); }, m_e);
+    }
+
+    template <class F, class... CT>
+    inline zarray_impl& zfunction<F, CT...>::assign_block_to(zarray_impl& res,
+                                                             detail::zblock_buffers& buffers,
+                                                             std::size_t offset,
+                                                             std::size_t size) const
+    {
+        return assign_block_impl(std::make_index_sequence<sizeof...(CT)>(), res, buffers, offset, size);
+    }
+
+    template <class F, class... CT>
+    inline auto zfunction<F, CT...>::compute_dimension() const -> size_type
+    {
+        auto func = [](size_type d, const auto& e) { return std::max(d, detail::get_dimension(e)); };
+        return accumulate(func, size_type(0), m_e);
+    }
+
+    template <class F, class... CT>
+    inline void zfunction<F, CT...>::compute_cached_shape() const
+    {
+        m_cache.shape = uninitialized_shape<shape_type>(compute_dimension());
+        m_cache.is_trivial = broadcast_shape(m_cache.shape, false);
+        m_cache.is_initialized = true;
+    }
+
+    // Returns true if the function can be evaluated concurrently.
+    // In that case, the lazily evaluated content of the leaves (such as
+    // the cache of an expression wrapper) is computed on the calling
+    // thread beforehand, so that the threads only read the leaves.
+    template <class F, class... CT>
+    inline bool zfunction<F, CT...>::prepare_concurrent_evaluation(bool chunked_result) const
+    {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+        if (compute_size(shape()) < XTENSOR_ZARRAY_PARALLEL_THRESHOLD || chunked_result || has_chunked_operand())
+        {
+            return false;
+        }
+        materialize_operands();
+        return true;
+#else
+        (void)chunked_result;
+        return false;
+#endif
     }
 
     template <class F, class... CT>
@@ -146,14 +738,118 @@ namespace xt
                );
     }
 
+    // Evaluates the arguments into their temporaries. The subtrees of the
+    // function are independent, so they are evaluated concurrently when
+    // concurrent is true; the buffer pool is thread local, the shapes of
+    // the whole tree have been computed by the planning pass, and the
+    // leaves have been materialized by prepare_concurrent_evaluation, so
+    // the arguments do not share any mutable state.
+    template <class F, class... CT>
+    inline auto zfunction<F, CT...>::evaluate_arguments(temporaries_type& tmp, bool concurrent) const -> arguments_type
+    {
+        arguments_type args;
+        detail::zparallel_for(sizeof...(CT), concurrent, [this, &tmp, &args](std::size_t i)
+        {
+            auto func = [&tmp, i](const auto& e) -> const zarray_impl& { return detail::get_array_impl(e, tmp[i]); };
+            args[i] = &apply<const zarray_impl&>(i, func, m_e);
+        });
+        return args;
+    }
+
+    // Evaluates the function node by node. When res is nullptr, the
+    // result is written into a temporary of an operand if possible
+    // (the functors are element-wise, so they can run in place),
+    // or into a buffer from the pool, which is returned.
     template <class F, class... CT>
     template <std::size_t... I>
-    inline zarray_impl& zfunction<F, CT...>::assign_to_impl(std::index_sequence<I...>, zarray_impl& res) const
+    inline auto zfunction<F, CT...>::assign_to_impl(std::index_sequence<I...>, zarray_impl* res, bool concurrent) const -> buffer_type
     {
-        dispatcher_type::dispatch(detail::get_array_impl(std::get<I>(m_e), res)..., res);
+        // Resolving the result type validates the types of the whole
+        // tree before any subtree is evaluated, possibly concurrently.
+        std::size_t index = get_result_type_index();
+        temporaries_type tmp;
+        arguments_type args = evaluate_arguments(tmp, concurrent);
+        buffer_type out;
+        if (res == nullptr)
+        {
+            out = detail::zreuse_temporary(tmp, index, shape());
+            res = out.get();
+        }
+        dispatcher_type::dispatch(*std::get<I>(args)..., *res);
+        for (auto& t : tmp)
+        {
+            if (t != nullptr)
+            {
+                zarray_impl_pool::release(std::move(t));
+            }
+        }
+        return out;
+    }
+
+    // The blocks are independent: when the evaluation can be concurrent,
+    // the blocks are split in ranges evaluated by different threads, each
+    // of them with its own block buffers.
+    template <class F, class... CT>
+    inline zarray_impl& zfunction<F, CT...>::assign_blocks_to(zarray_impl& res) const
+    {
+        std::size_t size = compute_size(shape());
+        if (size == 0)
+        {
+            return res;
+        }
+        std::size_t block_size = std::min(std::size_t(XTENSOR_ZARRAY_BLOCK_SIZE), size);
+        std::size_t nb_blocks = (size + block_size - 1) / block_size;
+        if (!prepare_concurrent_evaluation(res.is_chunked()))
+        {
+            assign_block_range(res, 0, nb_blocks, block_size);
+            return res;
+        }
+        // Ranges of blocks amortize the allocation of the block buffers
+        std::size_t blocks_per_range = std::max(std::size_t(1), std::size_t(XTENSOR_ZARRAY_PARALLEL_THRESHOLD) / (4 * block_size));
+        std::size_t nb_ranges = (nb_blocks + blocks_per_range - 1) / blocks_per_range;
+        detail::zparallel_for(nb_ranges, true, [this, &res, block_size, blocks_per_range, nb_blocks](std::size_t r)
+        {
+            std::size_t first = r * blocks_per_range;
+            assign_block_range(res, first, std::min(first + blocks_per_range, nb_blocks), block_size);
+        });
+        return res;
+    }
+
+    template <class F, class... CT>
+    inline void zfunction<F, CT...>::assign_block_range(zarray_impl& res,
+                                                        std::size_t first_block,
+                                                        std::size_t last_block,
+                                                        std::size_t block_size) const
+    {
+        std::size_t size = compute_size(shape());
+        detail::zblock_buffers buffers(block_size, shape());
+        zarray_impl& block = buffers.acquire(get_result_type_index());
+        allocate_blocks(buffers);
+        for (std::size_t b = first_block; b < last_block; ++b)
+        {
+            std::size_t offset = b * block_size;
+            // The first buffer holds the result block
+            buffers.rewind();
+            buffers.next();
+            assign_block_to(block, buffers, offset, std::min(block_size, size - offset));
+            res.set_block(block, offset);
+        }
+    }
+
+    template <class F, class... CT>
+    template <std::size_t... I>
+    inline zarray_impl& zfunction<F, CT...>::assign_block_impl(std::index_sequence<I...>,
+                                                               zarray_impl& res,
+                                                               detail::zblock_buffers& buffers,
+                                                               std::size_t offset,
+                                                               std::size_t size) const
+    {
+        // The elements of a braced-init-list are evaluated in order, so
+        // the buffers are consumed in the order they were allocated.
+        std::array<const zarray_impl*, sizeof...(CT)> args = {{ &detail::get_block_impl(std::get<I>(m_e), buffers, offset, size)... }};
+        dispatcher_type::dispatch(*std::get<I>(args)..., res);
         return res;
     }
 }
 
 #endif
-
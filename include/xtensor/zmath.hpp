@@ -11,19 +11,74 @@
 #define XTENSOR_ZMATH_HPP
 
 #include "xmath.hpp"
+#include "xnoalias.hpp"
 #include "zarray_impl.hpp"
 
 namespace xt
 {
     namespace detail
     {
-        // For further improvement: move shape computation
-        // at the beginning of a zarray assignment so it is computed
-        // only once
-        template <class E1, class E2>
-        inline void zassign_data(xexpression<E1>& e1, const xexpression<E2>& e2)
+        template <class S>
+        inline bool zsame_shape(const S&)
         {
-            e1.derived_cast() = e2.derived_cast();
+            return true;
+        }
+
+        template <class S, class S1, class... SN>
+        inline bool zsame_shape(const S& s, const S1& s1, const SN&... sn)
+        {
+            return s == s1 && zsame_shape(s, sn...);
+        }
+
+        // Results never alias their operands (each node of a zfunction
+        // tree gets its own buffer), so the temporary of the regular
+        // assignment can be avoided; this matters for the fused evaluation
+        // which runs the functors once per block. The zfunction planning
+        // pass has already resized the result, so when the operands have
+        // the same shape, the broadcast shape is not computed again.
+        template <class E1, class E2, class... S>
+        inline void zassign_data(xexpression<E1>& e1, const xexpression<E2>& e2, const S&... shapes)
+        {
+            if (zsame_shape(e1.derived_cast().shape(), shapes...))
+            {
+                xt::assign_data(e1, e2, true);
+            }
+            else
+            {
+                noalias(e1.derived_cast()) = e2.derived_cast();
+            }
+        }
+
+        // Calls f with the array held by z, or with the strided view it
+        // holds when z is a zview_wrapper, so that the functors read views
+        // in place instead of materializing them.
+        template <class T, class F>
+        inline void zvisit(const ztyped_array<T>& z, F&& f)
+        {
+            if (z.is_view())
+            {
+                f(static_cast<const zview_wrapper<T>&>(z).get_view());
+            }
+            else
+            {
+                f(z.get_array());
+            }
+        }
+
+        // Immediate reductions evaluate their argument into a container
+        // first, views are therefore reduced lazily to be read in place.
+        template <class E>
+        using zreducer_strategy_t = std::conditional_t<is_xarray<E>::value,
+                                                       std::tuple<evaluation_strategy::immediate_type>,
+                                                       std::tuple<evaluation_strategy::lazy_type>>;
+
+        template <class T1, class T2, class F>
+        inline void zvisit(const ztyped_array<T1>& z1, const ztyped_array<T2>& z2, F&& f)
+        {
+            zvisit(z1, [&z2, &f](const auto& e1)
+            {
+                zvisit(z2, [&e1, &f](const auto& e2) { f(e1, e2); });
+            });
         }
     }
 
@@ -44,7 +99,10 @@ namespace xt
         template <class T, class  R>                                               \
         static void run(const ztyped_array<T>& z, ztyped_array<R>& zres)           \
         {                                                                          \
-            detail::zassign_data(zres.get_array(), XOP z.get_array());             \
+            detail::zvisit(z, [&zres](const auto& e)                               \
+            {                                                                      \
+                detail::zassign_data(zres.get_array(), XOP e, e.shape());          \
+            });                                                                    \
         }                                                                          \
         template <class T>                                                         \
         static size_t index(const ztyped_array<T>&)                                \
@@ -64,8 +122,11 @@ namespace xt
                         const ztyped_array<T2>& z2,                                \
                         ztyped_array<R>& zres)                                     \
         {                                                                          \
-            detail::zassign_data(zres.get_array(),                                 \
-                                 z1.get_array() XOP z2.get_array());               \
+            detail::zvisit(z1, z2, [&zres](const auto& e1, const auto& e2)         \
+            {                                                                      \
+                detail::zassign_data(zres.get_array(), e1 XOP e2,                  \
+                                     e1.shape(), e2.shape());                      \
+            });                                                                    \
         }                                                                          \
         template <class T1, class T2>                                              \
         static size_t index(const ztyped_array<T1>&, const ztyped_array<T2>&)      \
@@ -84,7 +145,10 @@ namespace xt
         static void run(const ztyped_array<T>& z,                                  \
                         ztyped_array<R>& zres)                                     \
         {                                                                          \
-            detail::zassign_data(zres.get_array(), XEXP(z.get_array()));           \
+            detail::zvisit(z, [&zres](const auto& e)                               \
+            {                                                                      \
+                detail::zassign_data(zres.get_array(), XEXP(e), e.shape());        \
+            });                                                                    \
         }                                                                          \
         template <class T>                                                         \
         static size_t index(const ztyped_array<T>&)                                \
@@ -103,8 +167,11 @@ namespace xt
                         const ztyped_array<T2>& z2,                                \
                         ztyped_array<R>& zres)                                     \
         {                                                                          \
-            detail::zassign_data(zres.get_array(),                                 \
-                                 XEXP(z1.get_array(), z2.get_array()));            \
+            detail::zvisit(z1, z2, [&zres](const auto& e1, const auto& e2)         \
+            {                                                                      \
+                detail::zassign_data(zres.get_array(), XEXP(e1, e2),               \
+                                     e1.shape(), e2.shape());                      \
+            });                                                                    \
         }                                                                          \
         template <class T1, class T2>                                              \
         static size_t index(const ztyped_array<T1>&, const ztyped_array<T2>&)      \
@@ -116,6 +183,33 @@ namespace xt
     };                                                                             \
     XTENSOR_ZMAPPED_FUNCTOR(ZNAME, XFUN)
 
+#define XTENSOR_ZREDUCER(ZNAME, XEXP)                                              \
+    struct ZNAME                                                                   \
+    {                                                                              \
+        using axes_type = dynamic_shape<std::size_t>;                              \
+        template <class T>                                                         \
+        using result_type = typename decltype(                                     \
+            XEXP(std::declval<const xarray<T>&>(), std::declval<axes_type>(),      \
+                 evaluation_strategy::immediate))::value_type;                     \
+        template <class T, class R>                                                \
+        static void run(const ztyped_array<T>& z,                                  \
+                        ztyped_array<R>& zres,                                     \
+                        const axes_type& axes)                                     \
+        {                                                                          \
+            detail::zvisit(z, [&zres, &axes](const auto& e)                        \
+            {                                                                      \
+                using strategy = detail::zreducer_strategy_t<                      \
+                    std::decay_t<decltype(e)>>;                                    \
+                zres.get_array() = XEXP(e, axes, strategy());                      \
+            });                                                                    \
+        }                                                                          \
+        template <class T>                                                         \
+        static size_t index(const ztyped_array<T>&)                                \
+        {                                                                          \
+            return ztyped_array<result_type<T>>::get_class_static_index();         \
+        }                                                                          \
+    }
+
     XTENSOR_UNARY_ZOPERATOR(zidentity, +, detail::identity);
     XTENSOR_UNARY_ZOPERATOR(znegate, -, detail::negate);
     XTENSOR_BINARY_ZOPERATOR(zplus, +, detail::plus);
@@ -185,6 +279,13 @@ namespace xt
     XTENSOR_UNARY_ZFUNCTOR(zisinf, xt::isinf, math::isinf_fun);
     XTENSOR_UNARY_ZFUNCTOR(zisnan, xt::isnan, math::isnan_fun);
 
+    XTENSOR_ZREDUCER(zsum, xt::sum);
+    XTENSOR_ZREDUCER(zprod, xt::prod);
+    XTENSOR_ZREDUCER(zmean, xt::mean);
+    XTENSOR_ZREDUCER(zamax, xt::amax);
+    XTENSOR_ZREDUCER(zamin, xt::amin);
+
+#undef XTENSOR_ZREDUCER
 #undef XTENSOR_BINARY_ZFUNCTOR
 #undef XTENSOR_UNARY_ZFUNCTOR
 #undef XTENSOR_BINARY_ZOPERATOR
@@ -0,0 +1,57 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ZREDUCER_HPP
+#define XTENSOR_ZREDUCER_HPP
+
+#include <memory>
+#include <numeric>
+
+#include "zarray.hpp"
+#include "zdispatcher.hpp"
+
+namespace xt
+{
+    /**
+     * Reduces the zarray \c e over the given axes with the reducer
+     * functor \c F (zsum, zprod, zmean, zamax, zamin, or any functor
+     * registered in a zreducer_dispatcher). The reduction is dispatched
+     * on the value type of \c e and evaluated immediately.
+     * @param e the zarray to reduce
+     * @param axes the axes along which the reduction is performed,
+     * sorted and without duplicates
+     * @return a zarray holding the result
+     */
+    template <class F>
+    inline zarray zreduce(const zarray& e, const typename zreducer_dispatcher<F>::axes_type& axes)
+    {
+        using dispatcher_type = zreducer_dispatcher<F>;
+        const zarray_impl& impl = e.get_implementation();
+        std::size_t idx = dispatcher_type::get_type_index(impl);
+        std::unique_ptr<zarray_impl> res(zarray_impl_register::get(idx).clone());
+        dispatcher_type::dispatch(impl, *res, axes);
+        return zarray(std::move(res));
+    }
+
+    /**
+     * Reduces the zarray \c e over all its axes with the reducer functor \c F.
+     * @param e the zarray to reduce
+     * @return a zarray holding the result, of dimension 0
+     */
+    template <class F>
+    inline zarray zreduce(const zarray& e)
+    {
+        using axes_type = typename zreducer_dispatcher<F>::axes_type;
+        axes_type axes(e.get_implementation().shape().size());
+        std::iota(axes.begin(), axes.end(), std::size_t(0));
+        return zreduce<F>(e, axes);
+    }
+}
+
+#endif
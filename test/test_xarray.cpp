@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xeval.hpp"
 #include "xtensor/xmanipulation.hpp"
 #include "xtensor/xio.hpp"
 #include "test_common.hpp"
@@ -144,6 +145,24 @@ namespace xt
         }
     }
 
+    TEST(xarray, copy_on_write)
+    {
+        xarray_cow<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray_cow<double> b = a;
+        const auto& ca = a;
+        const auto& cb = b;
+        EXPECT_EQ(ca.data(), cb.data());
+        EXPECT_EQ(cb(1, 2), 6.);
+
+        b(1, 2) = 12.;
+        EXPECT_NE(ca.data(), cb.data());
+        EXPECT_EQ(ca(1, 2), 6.);
+        EXPECT_EQ(cb(1, 2), 12.);
+
+        xarray_cow<double> c = a + b;
+        EXPECT_EQ(c(1, 2), 18.);
+    }
+
     TEST(xarray, resize)
     {
         xarray_dynamic a;
@@ -378,4 +397,38 @@ namespace xt
         EXPECT_TRUE(d(2));
         EXPECT_FALSE(d(3));
     }
+
+    TEST(xarray, reuse_operand_buffer)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {{1., 1., 1.}, {2., 2., 2.}};
+
+        const double* a_data = a.data();
+        xarray<double> c = std::move(a) + b;
+        EXPECT_EQ(c.data(), a_data);
+        EXPECT_EQ(c(1, 2), 8.);
+
+        const double* c_data = c.data();
+        xarray<double> d = {1., 2.};
+        d = std::move(c) * 2.;
+        EXPECT_EQ(d.data(), c_data);
+        EXPECT_EQ(d(0, 1), 6.);
+
+        auto e = eval(std::move(d) - b);
+        EXPECT_EQ(e.data(), c_data);
+        EXPECT_EQ(e(1, 0), 8.);
+
+        // Broadcast operands can't give their buffer to the result
+        xarray<double> f = {1., 2., 3.};
+        xarray<double> g = std::move(f) + b;
+        EXPECT_EQ(g(1, 1), 4.);
+
+        // Neither can operands referred to by another operand
+        xarray<double> h = {{1., 2., 3.}, {4., 5., 6.}};
+        const double* h_data = h.data();
+        xarray<double> k = std::move(h) - h(0, 0);
+        xarray<double> expected = {{0., 1., 2.}, {3., 4., 5.}};
+        EXPECT_NE(k.data(), h_data);
+        EXPECT_EQ(k, expected);
+    }
 }
@@ -686,4 +686,35 @@ namespace xt
             EXPECT_EQ(tester.res_ru, b);
         }
     }
+
+    TEST(container_semantic, alias_analysis)
+    {
+        xarray<double> a = {{1., 2.}, {3., 4.}};
+        xarray<double> b = {{5., 6.}, {7., 8.}};
+        const double* data = a.data();
+
+        // Nothing aliases the destination: no temporary
+        a = b + 1.;
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(9., a(1, 1));
+
+        // The destination is only read elementwise
+        a = a * 2. + b;
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(23., a(1, 0));
+        a += b;
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(30., a(1, 0));
+
+        // The destination is read through a view
+        xarray<double> c = {{1., 2.}, {3., 4.}};
+        c = c + transpose(c);
+        xarray<double> expected1 = {{2., 5.}, {5., 8.}};
+        EXPECT_EQ(expected1, c);
+
+        // The destination is read through a scalar
+        c = c + c(0, 0);
+        xarray<double> expected2 = {{4., 7.}, {7., 10.}};
+        EXPECT_EQ(expected2, c);
+    }
 }
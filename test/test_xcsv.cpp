@@ -9,13 +9,17 @@
 
 #include "gtest/gtest.h"
 
+#include <clocale>
 #include <sstream>
+#include <string>
 #include <iostream>
 
 #include "xtensor/xcsv.hpp"
 #include "xtensor/xmath.hpp" 
 #include "xtensor/xio.hpp" 
 
+#include "test_common_macros.hpp"
+
 namespace xt
 {
     TEST(xcsv, load_double)
@@ -66,4 +70,119 @@ namespace xt
         dump_csv(res, data);
         ASSERT_EQ("1,2,3,4\n10,12,15,18\n", res.str());
     }
+
+    TEST(xcsv, dump_round_trip)
+    {
+        xtensor<double, 2> data = {{0.1 + 0.2, -3.0, 1e-300}};
+
+        std::stringstream res;
+        dump_csv(res, data);
+        ASSERT_EQ("0.30000000000000004,-3,1e-300\n", res.str());
+
+        auto loaded = load_csv<double>(res);
+        EXPECT_EQ(loaded, data);
+    }
+
+    TEST(xcsv, dump_locale_independent)
+    {
+        // The shortest representation does not depend on the C locale
+        const char* locales[] = {"de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR"};
+        for (const char* name : locales)
+        {
+            if (std::setlocale(LC_NUMERIC, name) != nullptr)
+            {
+                break;
+            }
+        }
+
+        char buffer[64];
+        char* last = detail::format_shortest_fallback(buffer, buffer + 64, 0.1 + 0.2);
+        std::string shortest(buffer, last);
+        xtensor<double, 2> data = {{0.1 + 0.2, -1.5}};
+        std::stringstream res;
+        dump_csv(res, data);
+        std::setlocale(LC_NUMERIC, "C");
+
+        EXPECT_EQ(shortest, "0.30000000000000004");
+        EXPECT_EQ(res.str(), "0.30000000000000004,-1.5\n");
+    }
+
+    TEST(xcsv, dump_int)
+    {
+        xtensor<int, 2> data = {{-12, 0, 7}, {2147483647, -2147483647 - 1, 10}};
+
+        std::stringstream res;
+        dump_csv(res, data);
+        ASSERT_EQ("-12,0,7\n2147483647,-2147483648,10\n", res.str());
+    }
+
+    TEST(xcsv, load_blocks)
+    {
+        std::string source =
+            "A B C\n"
+            "1.0 2.0 3.0\n"
+            "#4.0 5.0 6.0\n"
+            "7.0 8.0 9.0\n"
+            "10.0 11.0 12.0\n"
+            "13.0 14.0 15.0\n"
+            "16.0 17.0 18.0";
+
+        xcsv_config config;
+        config.delimiter = ' ';
+        config.skip_rows = 1;
+        config.max_rows = 4;
+
+        std::stringstream source_stream(source);
+        xcsv_block_reader<double> reader(source_stream, 3, config);
+
+        ASSERT_TRUE(reader.next());
+        xtensor<double, 2> exp0
+            {{ 1.0,  2.0,  3.0},
+             { 7.0,  8.0,  9.0},
+             {10.0, 11.0, 12.0}};
+        EXPECT_EQ(reader.block(), exp0);
+        const double* data = reader.block().data();
+
+        ASSERT_TRUE(reader.next());
+        xtensor<double, 2> exp1 = {{13.0, 14.0, 15.0}};
+        EXPECT_EQ(reader.block(), exp1);
+        EXPECT_EQ(reader.block().data(), data);
+
+        EXPECT_FALSE(reader.next());
+        EXPECT_EQ(reader.rows_read(), 4u);
+    }
+
+    TEST(xcsv, load_blocks_callback)
+    {
+        std::string source =
+            "1, 2\n"
+            "3, 4\n"
+            "5, 6\n"
+            "7, 8\n"
+            "9, 10";
+
+        std::stringstream source_stream(source);
+        std::size_t nb_blocks = 0;
+        double total = 0.;
+        std::size_t nb_rows = load_csv_blocks<double>(source_stream, 2, [&](const xcsv_tensor<double>& block)
+        {
+            ++nb_blocks;
+            total += sum(block)();
+        });
+
+        EXPECT_EQ(nb_rows, 5u);
+        EXPECT_EQ(nb_blocks, 3u);
+        EXPECT_EQ(total, 55.);
+    }
+
+    TEST(xcsv, load_blocks_inconsistent)
+    {
+        std::string source =
+            "1, 2\n"
+            "3, 4, 5";
+
+        std::stringstream source_stream(source);
+        xcsv_block_reader<int> reader(source_stream, 4);
+        XT_EXPECT_THROW(reader.next(), std::runtime_error);
+    }
 }
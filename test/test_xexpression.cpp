@@ -11,9 +11,11 @@
 #include <sstream>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xcached.hpp"
 #include "xtensor/xexpression.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xio.hpp"
+#include "xtensor/xvectorize.hpp"
 
 namespace xt
 {
@@ -115,6 +117,26 @@ namespace xt
         EXPECT_EQ(expr, a * a);
     }
 
+    TEST(xexpression, cached)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        std::size_t count = 0;
+        auto twice = [&count](double x) { ++count; return 2. * x; };
+
+        auto c = cached(vectorize(twice)(a));
+        EXPECT_EQ(count, std::size_t(0));
+        EXPECT_EQ(c.dimension(), std::size_t(2));
+
+        xarray<double> res = c * c + c;
+        EXPECT_EQ(count, a.size());
+        EXPECT_EQ(res, (2. * a) * (2. * a) + 2. * a);
+        EXPECT_EQ(c(1, 2), 12.);
+
+        xarray<double> res2 = c - a;
+        EXPECT_EQ(count, a.size());
+        EXPECT_EQ(res2, a);
+    }
+
     TEST(xexpression, temporary_type)
     {
         using dyn_shape = xt::svector<std::size_t, 4, std::allocator<std::size_t>, true>;
@@ -69,4 +69,24 @@ namespace xt
 
         ASSERT_EQ(a, b);
     }
+
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    TEST(xexpression_holder, typed_array)
+    {
+        xarray<float> a = {{1,2,3,4}, {5,6,7,8}};
+        xexpression_holder holder_a = xexpression_holder(a);
+
+        nlohmann::json json_out;
+        holder_a.to_json_typed_array(json_out);
+        EXPECT_TRUE(is_json_typed_array(json_out));
+
+        xexpression_holder holder_b;
+        from_json(json_out, holder_b);
+
+        nlohmann::json json_b;
+        to_json(json_b, holder_b);
+        xarray<float> b = json_b.get<xarray<float>>();
+        EXPECT_EQ(a, b);
+    }
+#endif
 }
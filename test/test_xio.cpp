@@ -21,6 +21,7 @@
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xdynamic_view.hpp"
 #include "xtensor/xview.hpp"
+#include "xtensor/xvectorize.hpp"
 
 #include "files/xio_expected_results.hpp"
 
@@ -330,4 +331,31 @@ namespace xt
         std::string exp = "{ 1.234000e+08,  1.234000e+08}\n2.119";
         EXPECT_EQ(exp, out.str());
     }
+
+    TEST(xio, stream_flags)
+    {
+        xarray<int> a = {10, 255};
+        std::stringstream hex_out;
+        hex_out << std::hex << a;
+        EXPECT_EQ("{  a,  ff}", hex_out.str());
+
+        std::stringstream upper_out;
+        upper_out << std::hex << std::uppercase << a;
+        EXPECT_EQ("{  A,  FF}", upper_out.str());
+
+        std::stringstream pos_out;
+        pos_out << std::showpos << a;
+        EXPECT_EQ("{+10, +255}", pos_out.str());
+    }
+
+    TEST(xio, summary_evaluates_edge_items)
+    {
+        std::size_t count = 0;
+        auto f = xt::vectorize([&count](double x) { ++count; return x; });
+        auto e = f(xt::ones<double>({100, 200, 300}));
+        std::stringstream out;
+        out << e;
+        // 3 edge items on both sides of each of the 3 dimensions
+        EXPECT_EQ(count, std::size_t(6 * 6 * 6));
+    }
 }
@@ -9,11 +9,15 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdint>
+#include <numeric>
 #include <string>
+#include <vector>
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xjson.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xview.hpp"
 
 namespace xt
@@ -62,4 +66,58 @@ namespace xt
             {3, 4}}});
         EXPECT_TRUE(all(equal(arr, ref)));
     }
+
+#if defined(XTENSOR_JSON_HAS_BINARY)
+    TEST(xjson, typed_array)
+    {
+        xt::xtensor<double, 2> t = {{1., 2., 3.}, {4., 5., 6.}};
+
+        nlohmann::json j;
+        to_json_typed_array(j, t);
+        EXPECT_TRUE(is_json_typed_array(j));
+        EXPECT_EQ(j["shape"], nlohmann::json({2, 3}));
+        EXPECT_EQ(j["data"].get_binary().size(), 6 * sizeof(double));
+
+        xt::xarray<double> res;
+        from_json(j, res);
+        EXPECT_EQ(res, t);
+    }
+
+    TEST(xjson, typed_array_cbor)
+    {
+        xt::xarray<int> a = xt::xarray<int>::from_shape({2, 2, 3});
+        std::iota(a.begin(), a.end(), -5);
+
+        nlohmann::json j;
+        to_json_typed_array(j, xt::transpose(a));
+        std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(j);
+        nlohmann::json k = nlohmann::json::from_cbor(cbor);
+
+        xt::xarray<int> res = k.get<xt::xarray<int>>();
+        EXPECT_EQ(res, xt::transpose(a));
+
+        xt::xarray<double> res_double;
+        from_json_typed_array(k, res_double);
+        EXPECT_EQ(res_double, xt::transpose(a));
+    }
+
+    TEST(xjson, typed_array_view)
+    {
+        xt::xarray<double> arr = {{1., 2.}, {3., 4.}};
+        xt::xarray<double> src = {10., 20.};
+
+        nlohmann::json j;
+        to_json_typed_array(j, src);
+        auto v = xt::view(arr, 1);
+        from_json(j, v);
+
+        xt::xarray<double> ref = {{1., 2.}, {10., 20.}};
+        EXPECT_EQ(arr, ref);
+
+        auto w = xt::view(arr, xt::all(), 0);
+        xt::xarray<double> wrong = {1., 2., 3.};
+        to_json_typed_array(j, wrong);
+        EXPECT_THROW(from_json(j, w), std::runtime_error);
+    }
+#endif
 }
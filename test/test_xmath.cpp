@@ -7,6 +7,7 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cmath>
 #include <complex>
 #include <limits>
 
@@ -16,6 +17,7 @@
 #include "xtensor/xoptional_assembly.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -880,4 +882,78 @@ namespace xt
 
         EXPECT_EQ(expected, xt::cov(x, y));
     }
+
+    TEST(xmath, variance_single_pass)
+    {
+        // Large offset, where the naive sum of squares loses all precision
+        xt::xarray<double> a = xt::arange<double>(200.);
+        a.reshape({4, 50});
+        a = 1e8 + xt::sin(a);
+        xt::xarray<double> mean_ref = xt::mean(a, {1});
+        xt::xarray<double> var_ref = xt::mean(xt::square(a - xt::view(mean_ref, xt::all(), xt::newaxis())), {1});
+
+        xt::xarray<double> var = xt::variance(a, {1});
+        xt::xarray<double> var_imm = xt::variance(a, {1}, xt::evaluation_strategy::immediate);
+        xt::xarray<double> var_ddof = xt::variance(a, {1}, 1);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            EXPECT_NEAR(var(i), var_ref(i), 1e-6);
+            EXPECT_NEAR(var_imm(i), var_ref(i), 1e-6);
+            EXPECT_NEAR(var_ddof(i), var_ref(i) * 50. / 49., 1e-6);
+        }
+
+        double total_mean = xt::mean(a)();
+        double total_var = xt::mean(xt::square(a - total_mean))();
+        EXPECT_NEAR(xt::variance(a)(), total_var, 1e-6);
+        EXPECT_NEAR(xt::variance(a, 1)(), total_var * 200. / 199., 1e-6);
+        EXPECT_NEAR(xt::stddev(a)(), std::sqrt(total_var), 1e-6);
+
+        // The immediate strategy yields a container, not a lazy expression
+        auto var_cont = xt::variance(a, {1}, xt::evaluation_strategy::immediate);
+        auto var_all = xt::variance(a, xt::evaluation_strategy::immediate);
+        EXPECT_TRUE(xt::has_data_interface<decltype(var_cont)>::value);
+        EXPECT_TRUE(xt::has_data_interface<decltype(var_all)>::value);
+        EXPECT_FALSE(xt::has_data_interface<decltype(xt::variance(a, {1}))>::value);
+        ASSERT_EQ(var_cont.size(), 4u);
+        EXPECT_NEAR(var_cont.data()[3], var_ref(3), 1e-6);
+        EXPECT_NEAR(var_all(), total_var, 1e-6);
+
+        xt::xarray<int> b = {{1, 2, 3}, {4, 6, 8}};
+        xt::xarray<double> var_int = xt::variance(b, {1});
+        EXPECT_DOUBLE_EQ(var_int(0), 2. / 3.);
+        EXPECT_DOUBLE_EQ(var_int(1), 8. / 3.);
+    }
+
+    TEST(xmath, moments)
+    {
+        xt::xarray<double> a = {{1., 2., 4., 7.}, {3., 3., 5., 11.}};
+
+        auto m = xt::moments(a)();
+        double mean = xt::mean(a)();
+        xt::xarray<double> d = a - mean;
+        double m2 = xt::mean(xt::pow(d, 2))();
+        double m3 = xt::mean(xt::pow(d, 3))();
+        double m4 = xt::mean(xt::pow(d, 4))();
+        EXPECT_NEAR(m[0], mean, 1e-12);
+        EXPECT_NEAR(m[1], m2, 1e-12);
+        EXPECT_NEAR(m[2], m3 / std::pow(m2, 1.5), 1e-12);
+        EXPECT_NEAR(m[3], m4 / (m2 * m2) - 3., 1e-12);
+
+        auto ma = xt::eval(xt::moments(a, {1}));
+        auto ma_imm = xt::moments(a, {1}, xt::evaluation_strategy::immediate);
+        EXPECT_TRUE(xt::has_data_interface<decltype(ma_imm)>::value);
+        xt::xarray<double> var = xt::variance(a, {1});
+        ASSERT_EQ(ma.size(), 2u);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            auto row = xt::eval(xt::view(a, i));
+            auto mr = xt::moments(row)();
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                EXPECT_NEAR(ma(i)[k], mr[k], 1e-12);
+                EXPECT_NEAR(ma_imm(i)[k], mr[k], 1e-12);
+            }
+            EXPECT_NEAR(ma(i)[1], var(i), 1e-12);
+        }
+    }
 }
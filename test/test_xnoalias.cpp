@@ -8,8 +8,11 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include "test_common_macros.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xmulti_assign.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xview.hpp"
 #include "test_xsemantic.hpp"
@@ -367,4 +370,30 @@ namespace xt
         xt::view(b, 1) = 10;
         EXPECT_EQ(a, b);
     }
+
+    TEST(xnoalias, multi_assign)
+    {
+        xtensor<double, 2> x = {{1., 5., 3.}, {4., 2., 6.}};
+
+        // Linear assignment by blocks
+        xtensor<double, 2> a, b;
+        multi_assign(std::tie(a, b), x + 1., x * 2.);
+        EXPECT_EQ(a, x + 1.);
+        EXPECT_EQ(b, x * 2.);
+
+        // Lockstep steppers
+        xtensor<double, 1> mn, mx, s;
+        multi_assign(std::tie(mn, mx, s), amin(x, {1}), amax(x, {1}), sum(x, {1}));
+        EXPECT_EQ(mn, xtensor<double, 1>({1., 2.}));
+        EXPECT_EQ(mx, xtensor<double, 1>({5., 6.}));
+        EXPECT_EQ(s, xtensor<double, 1>({9., 12.}));
+
+        xarray<int> c;
+        XT_EXPECT_THROW(multi_assign(std::tie(a, c), x, view(x, 0)), std::runtime_error);
+
+        // The destinations are not resized when the shapes do not match
+        XT_EXPECT_THROW(multi_assign(std::tie(mn, c), x, view(x, 0)), std::runtime_error);
+        EXPECT_EQ(mn, xtensor<double, 1>({1., 2.}));
+        EXPECT_EQ(c.dimension(), 0u);
+    }
 }
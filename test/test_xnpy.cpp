@@ -12,8 +12,13 @@
 #include "xtensor/xnpy.hpp"
 #include "xtensor/xarray.hpp"
 
+#include "test_common_macros.hpp"
+
+#include <algorithm>
+#include <complex>
 #include <fstream>
 #include <cstdint>
+#include <sstream>
 
 namespace xt
 {
@@ -66,6 +71,55 @@ namespace xt
         EXPECT_TRUE(all(equal(iarr1d, iarr1d_loaded)));
     }
 
+    TEST(xnpy, load_convert)
+    {
+        auto darr_loaded = load_npy<double>("files/xnpy_files/double.npy");
+
+        auto farr_loaded = load_npy<float>("files/xnpy_files/double.npy");
+        EXPECT_TRUE(all(isclose(xarray<float>(cast<float>(darr_loaded)), farr_loaded)));
+
+        auto larr_loaded = load_npy<std::int64_t>("files/xnpy_files/bool.npy");
+        auto barr_loaded = load_npy<bool>("files/xnpy_files/bool.npy");
+        EXPECT_TRUE(all(equal(cast<std::int64_t>(barr_loaded), larr_loaded)));
+
+        std::ifstream istream("files/xnpy_files/int.npy", std::ifstream::binary);
+        auto iarr_double = load_npy<double>(istream);
+        xarray<double> iarr1d = {3, 4, 5, 6, 7};
+        EXPECT_TRUE(all(equal(iarr1d, iarr_double)));
+
+        // Complex values cannot be converted to real values
+        xarray<std::complex<double>> carr = {{1., 2.}, {3., 4.}};
+        std::stringstream cstream(dump_npy(carr));
+        XT_EXPECT_THROW(load_npy<double>(cstream), std::runtime_error);
+    }
+
+    TEST(xnpy, load_swapped_byte_order)
+    {
+        xarray<std::int32_t> arr = {{1, -2, 3}, {256, 65536, -16777216}};
+        std::string content = dump_npy(arr);
+
+        // Rewrite the npy content with the opposite byte order
+        std::string host_type = detail::build_typestring<std::int32_t>();
+        std::string swapped_type = host_type;
+        swapped_type[0] = host_type[0] == '<' ? '>' : '<';
+        std::size_t type_pos = content.find(host_type);
+        ASSERT_NE(type_pos, std::string::npos);
+        content.replace(type_pos, host_type.size(), swapped_type);
+        std::size_t data_pos = content.size() - arr.size() * sizeof(std::int32_t);
+        for (std::size_t i = data_pos; i < content.size(); i += sizeof(std::int32_t))
+        {
+            std::reverse(content.begin() + std::ptrdiff_t(i), content.begin() + std::ptrdiff_t(i + sizeof(std::int32_t)));
+        }
+
+        std::stringstream istream(content);
+        auto loaded = load_npy<std::int32_t>(istream);
+        EXPECT_EQ(arr, loaded);
+
+        std::stringstream istream_double(content);
+        auto loaded_double = load_npy<double>(istream_double);
+        EXPECT_TRUE(all(equal(arr, loaded_double)));
+    }
+
     bool compare_binary_files(std::string fn1, std::string fn2)
     {
         std::ifstream stream1(fn1, std::ios::in | std::ios::binary);
@@ -0,0 +1,95 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xpadded.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using padded_type = xtensor_padded<double, 2>;
+
+    TEST(xpadded, shape)
+    {
+        padded_type a({3, 5});
+        EXPECT_EQ(a.size(), 15u);
+        EXPECT_GE(a.pitch(), 5u);
+        EXPECT_EQ(a.padding(), a.pitch() - 5u);
+        EXPECT_EQ(a.strides()[0], static_cast<std::ptrdiff_t>(a.pitch()));
+        EXPECT_EQ(a.strides()[1], 1);
+        EXPECT_EQ(a.storage().size(), 3 * a.pitch());
+        EXPECT_EQ(a.layout(), layout_type::row_major);
+        if (XTENSOR_DEFAULT_ALIGNMENT != 0)
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&a(2, 0)) % XTENSOR_DEFAULT_ALIGNMENT, std::uintptr_t(0));
+        }
+
+        a.resize({2, 8});
+        EXPECT_EQ(a.size(), 16u);
+        EXPECT_EQ(a.storage().size(), 2 * a.pitch());
+    }
+
+    TEST(xpadded, assign)
+    {
+        xtensor<double, 2> b = {{1., 2., 3., 4., 5.},
+                                {6., 7., 8., 9., 10.},
+                                {11., 12., 13., 14., 15.}};
+        padded_type a = b;
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a(1, 4), 10.);
+
+        // All operands padded: rows are computed with full batches
+        padded_type c = a + a * 2.;
+        xtensor<double, 2> expected = b * 3.;
+        EXPECT_EQ(c, expected);
+
+        // Mixed operands
+        xtensor<double, 2> d = a + b;
+        EXPECT_EQ(d, b * 2.);
+        padded_type e = c - b;
+        EXPECT_EQ(e, b * 2.);
+
+        padded_type f = {{1., 2., 3.}};
+        f = f + xtensor<double, 1>({1., 1., 1.});
+        EXPECT_EQ(f(0, 2), 4.);
+    }
+
+    TEST(xpadded, view)
+    {
+        padded_type a = {{1., 2., 3.}, {4., 5., 6.}};
+        auto v = view(a, 1, all());
+        EXPECT_EQ(v(2), 6.);
+        v = v * 2.;
+        EXPECT_EQ(a(1, 0), 8.);
+        EXPECT_EQ(a(0, 2), 3.);
+    }
+
+    TEST(xpadded, immediate_reducer)
+    {
+        xtensor<double, 2> b = {{1., 2., 3., 4., 5.},
+                                {6., 7., 8., 9., 10.},
+                                {11., 12., 13., 14., 15.}};
+        padded_type a = b;
+
+        EXPECT_EQ(sum(a, evaluation_strategy::immediate)(), 120.);
+        EXPECT_EQ(prod(a, evaluation_strategy::immediate)(), prod(b)());
+
+        xtensor<double, 1> sum0 = sum(a, {0}, evaluation_strategy::immediate);
+        xtensor<double, 1> sum1 = sum(a, {1}, evaluation_strategy::immediate);
+        EXPECT_EQ(sum0, sum(b, {0}));
+        EXPECT_EQ(sum1, sum(b, {1}));
+
+        xtensor<double, 1> prod1 = prod(a, {1}, evaluation_strategy::immediate);
+        EXPECT_EQ(prod1, prod(b, {1}));
+    }
+}
@@ -669,6 +669,50 @@ namespace xt
         EXPECT_TRUE(std::isnan(result2(0, 1, 0)));
     }
 
+    TEST(xreducer, simd_kernels)
+    {
+        // The sizes are not multiples of the SIMD width
+        xarray<double> a = xt::arange(185.) - 90.;
+        a.reshape({5, 37});
+
+        xarray<double> sum1 = xt::zeros<double>({5});
+        xarray<double> max1 = xt::zeros<double>({5});
+        xarray<double> sum0 = xt::zeros<double>({37});
+        xarray<double> min0 = xt::zeros<double>({37});
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            max1(i) = a(i, 0);
+            for (std::size_t j = 0; j < 37; ++j)
+            {
+                sum1(i) += a(i, j);
+                max1(i) = std::max(max1(i), a(i, j));
+                sum0(j) += a(i, j);
+                min0(j) = i == 0 ? a(i, j) : std::min(min0(j), a(i, j));
+            }
+        }
+
+        xarray<double> res = sum(a, {1});
+        EXPECT_EQ(res, sum1);
+        EXPECT_EQ(sum(a, {1}, evaluation_strategy::immediate), sum1);
+        res = amax(a, {1});
+        EXPECT_EQ(res, max1);
+        EXPECT_EQ(amax(a, {1}, evaluation_strategy::immediate), max1);
+        res = sum(a, {0});
+        EXPECT_EQ(res, sum0);
+        EXPECT_EQ(sum(a, {0}, evaluation_strategy::immediate), sum0);
+        res = amin(a, {0});
+        EXPECT_EQ(res, min0);
+        EXPECT_EQ(amin(a, {0}, evaluation_strategy::immediate), min0);
+        EXPECT_EQ(sum(a)(), -185.);
+        EXPECT_EQ(sum(a, evaluation_strategy::immediate)(), -185.);
+
+        a(2, 17) = std::numeric_limits<double>::quiet_NaN();
+        sum1(2) -= -90. + 2. * 37. + 17.;
+        res = nansum(a, {1});
+        EXPECT_EQ(res, sum1);
+        EXPECT_EQ(nansum(a, {1}, evaluation_strategy::immediate), sum1);
+    }
+
     TEST(xreducer, double_axis)
     {
         xt::xarray<int> a = xt::ones<int>({ 3, 2});
@@ -12,6 +12,7 @@
 #include "xtensor/xtensor_config.hpp"
 #include "xtensor/xstorage.hpp"
 #include <numeric>
+#include <thread>
 
 namespace xt
 {
@@ -53,6 +54,43 @@ namespace xt
         }
     }
 
+    TEST(uvector, push_back)
+    {
+        vector_type a;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            a.push_back(double(i));
+            EXPECT_GE(a.capacity(), a.size());
+        }
+        EXPECT_EQ(size_t(100), a.size());
+        EXPECT_LT(a.capacity(), size_t(200));
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(double(i), a[i]);
+        }
+
+        a.push_back(a[3]);
+        EXPECT_EQ(3., a.back());
+
+        a.shrink_to_fit();
+        EXPECT_EQ(a.size(), a.capacity());
+        EXPECT_EQ(3., a.back());
+    }
+
+    TEST(uvector, reserve)
+    {
+        vector_type a(10);
+        std::iota(a.begin(), a.end(), 0.);
+        a.reserve(50);
+        EXPECT_EQ(size_t(50), a.capacity());
+        const double* data = a.data();
+
+        // Growing within the capacity preserves the elements
+        a.resize(40);
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(9., a[9]);
+    }
+
     TEST(uvector, access)
     {
         vector_type a(10);
@@ -83,6 +121,64 @@ namespace xt
         }
     }
 
+    /***************
+     * cow_uvector *
+     ***************/
+
+    TEST(cow_uvector, copy_on_write)
+    {
+        using cow_type = cow_uvector<double>;
+        cow_type a(10, 1.);
+        cow_type b = a;
+        const cow_type& ca = a;
+        const cow_type& cb = b;
+        EXPECT_TRUE(a.is_shared());
+        EXPECT_EQ(ca.data(), cb.data());
+
+        b[0] = 2.;
+        EXPECT_FALSE(a.is_shared());
+        EXPECT_NE(ca.data(), cb.data());
+        EXPECT_EQ(1., a[0]);
+        EXPECT_EQ(2., b[0]);
+
+        cow_type c = std::move(b);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(size_t(10), c.size());
+
+        cow_type d = a;
+        d.resize(20);
+        EXPECT_EQ(size_t(10), a.size());
+        EXPECT_EQ(size_t(20), d.size());
+    }
+
+    TEST(cow_uvector, concurrent_copies)
+    {
+        using cow_type = cow_uvector<double>;
+        cow_type a(100, 1.);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < 4; ++t)
+        {
+            // Each worker writes to its own copies while the others read
+            workers.emplace_back([a]() mutable
+            {
+                for (std::size_t i = 0; i < 100; ++i)
+                {
+                    cow_type b = a;
+                    b[i] += 1.;
+                    a[i] = b[i];
+                }
+            });
+        }
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+        EXPECT_FALSE(a.is_shared());
+        EXPECT_EQ(1., a[99]);
+        a[0] = 2.;
+        EXPECT_EQ(2., a[0]);
+    }
+
     /***********
      * svector *
      ***********/
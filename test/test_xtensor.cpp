@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
 #include "test_common.hpp"
 #include <type_traits>
 
@@ -182,6 +183,38 @@ namespace xt
         test_throwing_reshape(b);
     }
 
+    TEST(xtensor, append)
+    {
+        xtensor<double, 1> a;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            a.push_back(double(i));
+        }
+        EXPECT_EQ(a.shape()[0], 20u);
+        EXPECT_EQ(a(19), 19.);
+        a.push_back(a(2));
+        EXPECT_EQ(a(20), 2.);
+
+        xtensor<double, 2> b = {{1., 2., 3.}};
+        b.append(xtensor<double, 1>{4., 5., 6.});
+        b.append(xtensor<double, 2>{{7., 8., 9.}, {10., 11., 12.}});
+        b.append(xt::view(b, 0));
+        xtensor<double, 2> expected = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}, {10., 11., 12.}, {1., 2., 3.}};
+        EXPECT_EQ(b, expected);
+
+        // The container itself, appended without reallocation
+        xtensor<double, 2> c = {{1., 2.}, {3., 4.}};
+        c.storage().reserve(16);
+        const double* data = c.data();
+        c.append(c);
+        xtensor<double, 2> expected2 = {{1., 2.}, {3., 4.}, {1., 2.}, {3., 4.}};
+        EXPECT_EQ(c.data(), data);
+        EXPECT_EQ(c, expected2);
+
+        XT_EXPECT_THROW(b.append(xtensor<double, 1>{1., 2.}), std::runtime_error);
+        XT_EXPECT_THROW(b.push_back(1.), std::runtime_error);
+    }
+
     TEST(xtensor, transpose)
     {
         xtensor_dynamic a;
@@ -11,12 +11,18 @@
 #include <type_traits>
 #include <tuple>
 #include <complex>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "test_common_macros.hpp"
+#include "xtensor/xarena_allocator.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xhuge_page_allocator.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xshape.hpp"
 #include "xtensor/xutils.hpp"
@@ -207,6 +213,190 @@ namespace xt
         XT_EXPECT_NO_THROW(arr_t c = a);
     }
 
+    struct stats_tag
+    {
+        static const char* name()
+        {
+            return "stats_tag";
+        }
+    };
+
+    TEST(utils, allocation_stats)
+    {
+        using arr_t = xarray<double, layout_type::row_major,
+                             tracking_allocator<double, std::allocator<double>, alloc_tracking::policy::stats>>;
+
+        arr_t a = {{1., 2., 3.}, {5., 6., 7.}};
+        alloc_tracking::reset();
+        {
+            arr_t b = a + 123.;
+            arr_t c = b * 2.;
+            EXPECT_EQ(c(1, 2), 260.);
+        }
+        alloc_tracking::alloc_stats st = alloc_tracking::total();
+        EXPECT_EQ(st.allocations, 2u);
+        EXPECT_EQ(st.deallocations, 2u);
+        EXPECT_EQ(st.allocated_bytes, 12 * sizeof(double));
+        EXPECT_EQ(st.live_bytes, 6 * sizeof(double));
+        EXPECT_EQ(st.peak_live_bytes, 18 * sizeof(double));
+        EXPECT_EQ(st.size_histogram[alloc_tracking::detail::histogram_bucket(6 * sizeof(double))], 2u);
+
+        auto per_type = alloc_tracking::snapshot();
+        EXPECT_EQ(per_type[typeid(double).name()].allocations, 2u);
+
+        // Containers of the same value type are told apart by their tag
+        using tagged_t = xarray<double, layout_type::row_major,
+                                tracking_allocator<double, std::allocator<double>, alloc_tracking::policy::stats, stats_tag>>;
+        {
+            tagged_t d = a * 3.;
+            EXPECT_EQ(d(0, 0), 3.);
+        }
+        auto per_name = alloc_tracking::snapshot();
+        EXPECT_EQ(per_name["stats_tag"].allocations, 1u);
+        EXPECT_EQ(per_name[typeid(double).name()].allocations, 2u);
+        EXPECT_EQ(alloc_tracking::total().allocations, 3u);
+
+        // Allocations from several threads are aggregated
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&a]() { tagged_t e = a + 1.; });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        st = alloc_tracking::total();
+        EXPECT_EQ(alloc_tracking::snapshot()["stats_tag"].allocations, 5u);
+        EXPECT_EQ(st.live_bytes, 6 * sizeof(double));
+    }
+
+    TEST(utils, arena_allocator)
+    {
+        using arr_t = xarray<double, layout_type::row_major, xarena_allocator<double>>;
+
+        arr_t a = {{1., 2., 3.}, {4., 5., 6.}};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, std::uintptr_t(0));
+        arr_t b = a + 1.;
+        EXPECT_EQ(b(1, 2), 7.);
+
+        // Blocks of the same size class are recycled
+        xarena_allocator<double> alloc;
+        double* p = alloc.allocate(10);
+        alloc.deallocate(p, 10);
+        double* q = alloc.allocate(12);
+        EXPECT_EQ(p, q);
+        alloc.deallocate(q, 12);
+
+        // Large blocks are allocated on the heap
+        std::size_t n = XTENSOR_ARENA_MAX_BLOCK_SIZE / sizeof(double) + 1;
+        double* r = alloc.allocate(n);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(r) % 64, std::uintptr_t(0));
+        alloc.deallocate(r, n);
+
+        // Blocks allocated within a scope are recycled by the scope only
+        const double* scoped_data = nullptr;
+        {
+            xarena_scope scope;
+            arr_t c = a * 2.;
+            EXPECT_EQ(c(0, 1), 4.);
+            scoped_data = c.data();
+        }
+        {
+            xarena_scope scope;
+            arr_t d = a * 3.;
+            EXPECT_EQ(d(1, 0), 12.);
+            EXPECT_EQ(d.data(), scoped_data);
+        }
+
+        // A block deallocated by another thread goes back to its arena
+        double* s = alloc.allocate(1000);
+        std::thread([&alloc, s]() { alloc.deallocate(s, 1000); }).join();
+        double* t = alloc.allocate(1000);
+        EXPECT_EQ(s, t);
+        alloc.deallocate(t, 1000);
+
+        // The arena of a thread that exits is reused by the next one
+        double* u = nullptr;
+        double* v = nullptr;
+        std::thread([&alloc, &u]() { u = alloc.allocate(3000); alloc.deallocate(u, 3000); }).join();
+        std::thread([&alloc, &v]() { v = alloc.allocate(3000); alloc.deallocate(v, 3000); }).join();
+        EXPECT_EQ(u, v);
+
+        // A block outliving its scope remains valid, the scope is counted
+        std::size_t outliving = xarena_scope::outliving_scopes();
+        arr_t escaped;
+        {
+            xarena_scope scope;
+            escaped = a * 4.;
+        }
+        EXPECT_EQ(xarena_scope::outliving_scopes(), outliving + 1);
+        EXPECT_EQ(escaped(1, 2), 24.);
+        arr_t other = a * 5.;
+        EXPECT_EQ(escaped(1, 2), 24.);
+        EXPECT_EQ(other(1, 2), 30.);
+    }
+
+    TEST(utils, huge_page_allocator)
+    {
+        using arr_t = xtensor<double, 1, layout_type::row_major, huge_page_allocator<double>>;
+
+        arr_t a = {1., 2., 3.};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, std::uintptr_t(0));
+
+        std::size_t n = XTENSOR_HUGE_PAGE_THRESHOLD / sizeof(double) + 1;
+        arr_t b = xt::zeros<double>({n});
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.data()) % 64, std::uintptr_t(0));
+        EXPECT_EQ(b(n - 1), 0.);
+        arr_t c = b + 1.;
+        EXPECT_EQ(c(n / 2), 1.);
+
+#if defined(__linux__)
+        // Mapped blocks start on a huge page
+        std::uintptr_t huge_page = std::uintptr_t(1) << 21;
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.data()) % huge_page, std::uintptr_t(0));
+
+        huge_page_allocator<double> dalloc;
+        double* g = dalloc.allocate(n);
+        g[n - 1] = 3.;
+        g = dalloc.reallocate(g, n, 4 * n);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(g) % huge_page, std::uintptr_t(0));
+        EXPECT_EQ(g[n - 1], 3.);
+        dalloc.deallocate(g, 4 * n);
+#endif
+
+#if defined(XTENSOR_USE_NUMA)
+        // The pages are spread across the nodes the process can use
+        constexpr std::size_t max_nodes = 1024;
+        constexpr std::size_t bits = sizeof(unsigned long) * 8;
+        unsigned long allowed[max_nodes / bits] = {};
+        ASSERT_EQ(get_mempolicy(nullptr, allowed, max_nodes, nullptr, MPOL_F_MEMS_ALLOWED), 0);
+        std::size_t nb_nodes = 0;
+        for (std::size_t node = 0; node < max_nodes; ++node)
+        {
+            nb_nodes += (allowed[node / bits] >> (node % bits)) & 1UL;
+        }
+
+        std::size_t nb_huge_pages = 8;
+        std::size_t m = nb_huge_pages * huge_page / sizeof(int);
+        huge_page_allocator<int, numa_policy::interleave> alloc;
+        int* p = alloc.allocate(m);
+        int mode = -1;
+        ASSERT_EQ(get_mempolicy(&mode, nullptr, 0, p, MPOL_F_ADDR), 0);
+        EXPECT_EQ(mode, MPOL_INTERLEAVE);
+        std::set<int> nodes;
+        for (std::size_t i = 0; i < m; i += 4096 / sizeof(int))
+        {
+            p[i] = 1;
+            int node = -1;
+            ASSERT_EQ(get_mempolicy(&node, nullptr, 0, p + i, MPOL_F_NODE | MPOL_F_ADDR), 0);
+            nodes.insert(node);
+        }
+        EXPECT_GE(nodes.size(), std::min(nb_nodes, nb_huge_pages));
+        alloc.deallocate(p, m);
+#endif
+    }
+
     TEST(utils, static_dimension)
     {
         std::ptrdiff_t sdim = static_dimension<std::vector<int>>::value;
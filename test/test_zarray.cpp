@@ -7,9 +7,19 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "xtensor/xchunk_store_manager.hpp"
+#include "xtensor/xcsv.hpp"
+#include "xtensor/xdisk_io_handler.hpp"
+#include "xtensor/xfile_array.hpp"
 #include "xtensor/zarray.hpp"
 #include "xtensor/zfunction.hpp"
+#include "xtensor/zreducer.hpp"
 
 #ifndef XTENSOR_DISABLE_EXCEPTIONS
 namespace xt
@@ -122,6 +132,436 @@ namespace xt
         const auto& res = zres.get_array<double>();
         EXPECT_TRUE(all(isclose(res, expected)));
     }
+
+    TEST(zarray, shape)
+    {
+        xarray<double> a = {{0.5, 1.5}, {2.5, 3.5}};
+        xarray<double> b = {-0.2, 2.4};
+        xarray<double> c = {-0.2, 2.4, 1.3};
+
+        zarray za(a);
+        zarray zb(b);
+        zarray zc(c);
+
+        auto f = za + xt::exp(zb);
+        zarray_impl::shape_type expected = {2, 2};
+        EXPECT_EQ(f.dimension(), 2u);
+        EXPECT_EQ(f.shape(), expected);
+        EXPECT_FALSE(f.is_trivial_broadcast());
+
+        auto g = zb - xt::exp(zb);
+        EXPECT_TRUE(g.is_trivial_broadcast());
+
+        auto h = za + zc;
+        EXPECT_THROW(h.shape(), broadcast_error);
+        EXPECT_THROW(zarray zres = za * zc, broadcast_error);
+    }
+
+    TEST(zarray, fused_evaluation)
+    {
+        // Spans several blocks, the last one being partial
+        std::size_t n = XTENSOR_ZARRAY_BLOCK_SIZE + 37;
+        xarray<double> a = arange<double>(double(3 * n));
+        a.reshape({3, n});
+        xarray<double> b = 2. * a + 1.;
+        xarray<double> c = a / 5.;
+        xarray<double> d = -a;
+
+        zarray za(a);
+        zarray zb(b);
+        zarray zc(c);
+        zarray zd(d);
+
+        zarray zres = (za + zb) * zc - xt::exp(zd);
+        xarray<double> expected = (a + b) * c - xt::exp(d);
+
+        const auto& res = zres.get_array<double>();
+        EXPECT_EQ(res.shape(), expected.shape());
+        EXPECT_TRUE(all(isclose(res, expected)));
+    }
+
+    TEST(zarray, broadcast_evaluation)
+    {
+        xarray<double> a = {{0.5, 1.5}, {2.5, 3.5}};
+        xarray<double> b = {-0.2, 2.4};
+        xarray<double> c = {{1.3, 4.7}, {0.1, 0.2}};
+
+        zarray za(a);
+        zarray zb(b);
+        zarray zc(c);
+
+        zarray zres = (za + zb) * (zc - zb);
+        xarray<double> expected = (a + b) * (c - b);
+
+        const auto& res = zres.get_array<double>();
+        EXPECT_TRUE(all(isclose(res, expected)));
+    }
+
+    TEST(zarray, pooled_evaluation)
+    {
+        xarray<double> a = {{0.5, 1.5}, {2.5, 3.5}};
+        xarray<double> b = {-0.2, 2.4};
+        xarray<double> c = {{1.3, 4.7}, {0.1, 0.2}};
+
+        zarray za(a);
+        zarray zb(b);
+        zarray zc(c);
+
+        zarray_impl_pool::clear();
+        zarray zres = (za + zb) * (zc - zb);
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), (a + b) * (c - b))));
+
+        // One temporary holds the result, the other one is back in the pool
+        std::size_t idx = ztyped_array<double>::get_class_static_index();
+        auto buffer = zarray_impl_pool::acquire(idx, a.size());
+        EXPECT_EQ(buffer->shape(), zres.get_implementation().shape());
+        zarray_impl_pool::release(std::move(buffer));
+
+        zres = (za + zb) * (zc - zb);
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), (a + b) * (c - b))));
+    }
+
+    TEST(zarray, pool_budget)
+    {
+        std::size_t idx = ztyped_array<double>::get_class_static_index();
+        zarray_impl_pool::clear();
+
+        auto small = zarray_impl_pool::acquire(idx, 4);
+        small->resize({4});
+        zarray_impl_pool::release(std::move(small));
+        EXPECT_EQ(zarray_impl_pool::pooled_bytes(), 4 * sizeof(double));
+
+        // A buffer of another size is not handed back
+        auto other = zarray_impl_pool::acquire(idx, 6);
+        EXPECT_NE(compute_size(other->shape()), std::size_t(4));
+        EXPECT_EQ(zarray_impl_pool::pooled_bytes(), 4 * sizeof(double));
+
+        // A buffer larger than the budget is not pooled
+        std::size_t large_size = XTENSOR_ZARRAY_POOL_BYTES / sizeof(double) + 1;
+        auto large = zarray_impl_pool::acquire(idx, large_size);
+        large->resize({large_size});
+        zarray_impl_pool::release(std::move(large));
+        EXPECT_EQ(zarray_impl_pool::pooled_bytes(), 4 * sizeof(double));
+        auto large2 = zarray_impl_pool::acquire(idx, large_size);
+        EXPECT_NE(compute_size(large2->shape()), large_size);
+
+        auto small2 = zarray_impl_pool::acquire(idx, 4);
+        EXPECT_EQ(compute_size(small2->shape()), std::size_t(4));
+        EXPECT_EQ(zarray_impl_pool::pooled_bytes(), std::size_t(0));
+    }
+
+    TEST(zarray, rvalue_operand_reuse)
+    {
+        xarray<double> a = {{0.5, 1.5}, {2.5, 3.5}};
+        xarray<double> b = {{-0.2, 2.4}, {1.3, 4.7}};
+        xarray<double> expected = a + xt::exp(b);
+        zarray zb(b);
+
+        xarray<double> ca = a;
+        zarray za(std::move(ca));
+        const double* data = za.get_array<double>().data();
+        zarray zres = std::move(za) + xt::exp(zb);
+        EXPECT_EQ(zres.get_array<double>().data(), data);
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+
+        // An operand wrapping an external array is never written
+        xarray<double> a_copy = a;
+        zarray zl(a);
+        zres = std::move(zl) + xt::exp(zb);
+        EXPECT_EQ(a, a_copy);
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+    }
+
+    TEST(zarray, reducers)
+    {
+        xarray<double> a = {{{0.5, 1.5, 2.}, {2.5, 3.5, -1.}},
+                            {{-4., 1.5, 8.}, {0.25, 6.5, 3.}}};
+        zarray za(a);
+
+        zarray zs = zreduce<zsum>(za, {1});
+        xarray<double> s = sum(a, {1}, evaluation_strategy::immediate);
+        EXPECT_EQ(zs.get_array<double>(), s);
+
+        zarray zm = zreduce<zmean>(za, {0, 2});
+        xarray<double> m = mean(a, {0, 2}, evaluation_strategy::immediate);
+        EXPECT_TRUE(all(isclose(zm.get_array<double>(), m)));
+
+        zarray zmax = zreduce<zamax>(za);
+        EXPECT_EQ(zmax.get_array<double>().dimension(), 0u);
+        EXPECT_EQ(zmax.get_array<double>()(), 8.);
+
+        xarray<float> f = {{1.f, 2.f}, {3.f, 4.f}};
+        zarray zf(f);
+        zarray zp = zreduce<zprod>(zf, {0});
+        using prod_type = zprod::result_type<float>;
+        xarray<prod_type> p = {3.f, 8.f};
+        EXPECT_EQ(zp.get_array<prod_type>(), p);
+    }
+
+    TEST(zarray, strided_view)
+    {
+        xarray<double> a = {{0.5, 1.5, 2.5}, {3.5, 4.5, 5.5}, {6.5, 7.5, 8.5}};
+        xarray<double> b = {{-0.2, 2.4}, {1.3, 4.7}};
+        zarray za(a);
+        zarray zb(b);
+
+        zarray zv = zstrided_view(za, {range(1, 3), range(0, 3, 2)});
+        EXPECT_TRUE(zv.get_implementation().is_view());
+        EXPECT_FALSE(zv.get_implementation().owns_data());
+        zarray_impl::shape_type expected_shape = {2, 2};
+        EXPECT_EQ(zv.get_implementation().shape(), expected_shape);
+
+        xarray<double> expected = strided_view(a, {range(1, 3), range(0, 3, 2)}) + b;
+        zarray zres = zv + zb;
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+
+        // Broadcasting operation mixing a view and a container
+        xarray<double> c = {{1., 2., 3.}, {4., 5., 6.}};
+        zarray zc(c);
+        zarray zr = zstrided_view(za, {1, all()});
+        xarray<double> expected2 = c * strided_view(a, {1, all()});
+        zarray zres2 = zc * zr;
+        EXPECT_EQ(zres2.get_array<double>(), expected2);
+
+        // Views read the viewed buffer in place
+        a(1, 0) = 10.;
+        expected(0, 0) = 10. + b(0, 0);
+        zres = zv + zb;
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+
+        // The copy returned by get_array is computed once, while
+        // the operations keep reading the viewed array
+        EXPECT_EQ(zv.get_array<double>()(0, 0), 10.);
+        a(1, 0) = 11.;
+        EXPECT_EQ(zv.get_array<double>()(0, 0), 10.);
+        zres = zv + zb;
+        EXPECT_DOUBLE_EQ(zres.get_array<double>()(0, 0), 11. + b(0, 0));
+
+        // Concurrent calls to get_array share the same copy
+        zarray zv2 = zstrided_view(za, {all(), 1});
+        const zarray& czv2 = zv2;
+        std::vector<const double*> copies(4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < copies.size(); ++i)
+        {
+            threads.emplace_back([&czv2, &copies, i]() { copies[i] = czv2.get_array<double>().data(); });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        EXPECT_TRUE(std::all_of(copies.cbegin(), copies.cend(), [&copies](const double* p) { return p == copies[0]; }));
+        EXPECT_EQ(czv2.get_array<double>(), strided_view(a, {all(), 1}));
+
+        // Views are reduced in place
+        zarray zs = zreduce<zsum>(zv, {0});
+        xarray<double> expected_sum = sum(strided_view(a, {range(1, 3), range(0, 3, 2)}), {0});
+        EXPECT_TRUE(all(isclose(zs.get_array<double>(), expected_sum)));
+        a(1, 0) = 10.;
+
+        // A view of a view shares the buffer of the temporary zarray
+        zarray zw = zstrided_view(zstrided_view(zarray(xarray<double>(a)), {range(1, 3), all()}), {all(), 2});
+        xarray<double> expected3 = strided_view(a, {range(1, 3), 2});
+        zarray zres3 = -zw;
+        EXPECT_EQ(zres3.get_array<double>(), -expected3);
+    }
+
+    TEST(zarray, computed_assign)
+    {
+        xarray<double> a = {{0.5, 1.5}, {2.5, 3.5}};
+        xarray<double> b = {{-0.2, 2.4}, {1.3, 4.7}};
+        xarray<double> r = {1., 2.};
+        zarray zb(b);
+        zarray zr(r);
+
+        zarray za(xarray<double>(a));
+        const double* data = za.get_array<double>().data();
+
+        za += zb;
+        xarray<double> expected = a + b;
+        EXPECT_EQ(za.get_array<double>().data(), data);
+        EXPECT_TRUE(all(isclose(za.get_array<double>(), expected)));
+
+        za *= xt::exp(zb);
+        expected *= xt::exp(b);
+        EXPECT_EQ(za.get_array<double>().data(), data);
+        EXPECT_TRUE(all(isclose(za.get_array<double>(), expected)));
+
+        za -= zr;
+        expected -= r;
+        EXPECT_EQ(za.get_array<double>().data(), data);
+        EXPECT_TRUE(all(isclose(za.get_array<double>(), expected)));
+
+        // An external array is never written to, even
+        // when it can hold the result
+        xarray<double> a_copy = a;
+        zarray zl(a_copy);
+        zl += zb;
+        EXPECT_NE(zl.get_array<double>().data(), a_copy.data());
+        EXPECT_EQ(a_copy, a);
+        EXPECT_TRUE(all(isclose(zl.get_array<double>(), a + b)));
+
+        zarray zn(a_copy);
+        noalias(zn) = za + zb;
+        EXPECT_EQ(a_copy, a);
+        EXPECT_TRUE(all(isclose(zn.get_array<double>(), expected + b)));
+
+        xarray<double> r_copy = r;
+        zarray zlr(r_copy);
+        zlr += zb;
+        EXPECT_EQ(r_copy, r);
+        EXPECT_TRUE(all(isclose(zlr.get_array<double>(), r + b)));
+
+        // A view on the left-hand side operand prevents the in-place evaluation
+        zarray zc(xarray<double>(a));
+        zc += zstrided_view(zc, {range(0, 1), all()});
+        xarray<double> expected2 = a + strided_view(a, {range(0, 1), all()});
+        EXPECT_TRUE(all(isclose(zc.get_array<double>(), expected2)));
+
+        // Assigning to a view writes to the viewed array
+        zarray zd(xarray<double>(a));
+        zarray zv = zstrided_view(zd, {all(), 1});
+        zv += zr;
+        xarray<double> expected3 = a;
+        strided_view(expected3, {all(), 1}) += r;
+        EXPECT_TRUE(zv.get_implementation().is_view());
+        EXPECT_TRUE(all(isclose(zd.get_array<double>(), expected3)));
+
+        noalias(zv) = zv * zstrided_view(zd, {all(), 0});
+        strided_view(expected3, {all(), 1}) *= strided_view(expected3, {all(), 0});
+        EXPECT_TRUE(all(isclose(zd.get_array<double>(), expected3)));
+
+        // A view on an external array is not written to
+        zarray zl2(a_copy);
+        zarray zv2 = zstrided_view(zl2, {all(), 1});
+        XT_EXPECT_THROW(zv2 += zr, std::runtime_error);
+        EXPECT_EQ(a_copy, a);
+    }
+
+    TEST(zarray, concurrent_evaluation)
+    {
+        // Large enough to be evaluated concurrently when xtensor
+        // is built with TBB or OpenMP
+        std::size_t n = std::size_t(XTENSOR_ZARRAY_PARALLEL_THRESHOLD);
+        xarray<double> a = xt::arange<double>(double(2 * n));
+        a.reshape({std::size_t(2), n});
+        xarray<double> r = xt::arange<double>(double(n));
+
+        // Both operands share the cache of the same expression wrapper
+        zarray ze(a + 1.);
+        zarray zr(r);
+
+        zarray zres = ze * ze + ze;
+        xarray<double> expected = (a + 1.) * (a + 1.) + (a + 1.);
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+
+        zarray zres2 = ze * ze - zr;
+        xarray<double> expected2 = (a + 1.) * (a + 1.) - r;
+        EXPECT_TRUE(all(isclose(zres2.get_array<double>(), expected2)));
+    }
+
+    TEST(zarray, chunked)
+    {
+        using chunked_type = xchunked_array<xarray<xarray<double>>>;
+        std::vector<std::size_t> shape = {3, 5};
+        std::vector<std::size_t> chunk_shape = {2, 2};
+        xarray<double> a = {{0.5, 1.5, 2.5, 3.5, 4.5},
+                            {5.5, 6.5, 7.5, 8.5, 9.5},
+                            {1.0, 2.0, 3.0, 4.0, 5.0}};
+        xarray<double> b = {{-0.2, 2.4, 1.3, 4.7, 0.1},
+                            {1.2, -3.4, 0.8, 2.2, 6.1},
+                            {0.3, 0.6, -0.9, 1.2, 1.5}};
+        xarray<double> r = {1., 2., 3., 4., 5.};
+        chunked_type ca(a, chunk_shape);
+        zarray za(ca);
+        zarray zb(b);
+        zarray zr(r);
+        EXPECT_TRUE(za.get_implementation().is_chunked());
+
+        zarray zres = za + zb;
+        xarray<double> expected = a + b;
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected)));
+
+        // The result is written chunk by chunk into the
+        // chunked array, although the zarray does not own it
+        chunked_type cres(shape, chunk_shape);
+        zarray zc(cres);
+        EXPECT_FALSE(zc.get_implementation().owns_data());
+        EXPECT_TRUE(zc.get_implementation().accepts_in_place_result());
+        noalias(zc) = za * zb + zb;
+        xarray<double> expected2 = a * b + b;
+        EXPECT_TRUE(all(isclose(cres, expected2)));
+
+        noalias(zc) = za - zr;
+        xarray<double> expected3 = a - r;
+        EXPECT_TRUE(all(isclose(cres, expected3)));
+    }
+
+    // Names the files of the chunks so that they do not
+    // collide with those of the xchunked_array tests
+    class zarray_index_path
+    {
+    public:
+
+        void set_directory(const char*)
+        {
+        }
+
+        template <class I>
+        void index_to_path(I first, I last, std::string& path)
+        {
+            path = "zarray_chunk";
+            for (auto it = first; it != last; ++it)
+            {
+                path.push_back('.');
+                path.append(std::to_string(*it));
+            }
+        }
+    };
+
+    TEST(zarray, disk_chunked)
+    {
+        using file_array = xfile_array<double, xdisk_io_handler<xcsv_config>>;
+        using chunked_type = xchunked_array<xchunk_store_manager<file_array, zarray_index_path>>;
+        std::vector<std::size_t> shape = {3, 5};
+        std::vector<std::size_t> chunk_shape = {2, 2};
+        xarray<double> a = {{0.5, 1.5, 2.5, 3.5, 4.5},
+                            {5.5, 6.5, 7.5, 8.5, 9.5},
+                            {1.0, 2.0, 3.0, 4.0, 5.0}};
+        xarray<double> b = {{-0.2, 2.4, 1.3, 4.7, 0.1},
+                            {1.2, -3.4, 0.8, 2.2, 6.1},
+                            {0.3, 0.6, -0.9, 1.2, 1.5}};
+        xarray<double> r = {1., 2., 3., 4., 5.};
+        zarray za(a);
+        zarray zb(b);
+        zarray zr(r);
+
+        // The pool holds fewer chunks than a row of chunks,
+        // so that chunks are saved and loaded between blocks
+        chunked_type cres(shape, chunk_shape);
+        cres.chunks().set_pool_size(2);
+        zarray zc(cres);
+
+        noalias(zc) = za * zb + zb;
+        xarray<double> expected = a * b + b;
+        EXPECT_TRUE(all(isclose(zc.get_array<double>(), expected)));
+        EXPECT_DOUBLE_EQ(cres(2, 4), expected(2, 4));
+
+        // The broadcast leaf is read block by block too
+        noalias(zc) = za - zr;
+        xarray<double> expected2 = a - r;
+        EXPECT_TRUE(all(isclose(zc.get_array<double>(), expected2)));
+
+        // The chunks are read back as an operand
+        zarray zres = zc * zb;
+        EXPECT_TRUE(all(isclose(zres.get_array<double>(), expected2 * b)));
+
+        cres.chunks().flush();
+        std::ifstream in_file("zarray_chunk.0.1");
+        xarray<double> data = load_csv<double>(in_file);
+        xarray<double> ref = {{expected2(0, 2), expected2(0, 3)},
+                              {expected2(1, 2), expected2(1, 3)}};
+        EXPECT_TRUE(all(isclose(data, ref)));
+    }
 }
 #endif
-